@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Calibration math benchmark.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef BENCH_H_
+#define	BENCH_H_
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <xc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+/// Benchmark execution enable.
+///
+/// @note   The benchmark is performed at startup and delays the start of the
+///         software cycle processing (several seconds - every int16 servo
+///         position command and every 12-bit VSENSE count is evaluated by
+///         each evaluator); therefore, it is disabled by default.  The
+///         benchmark is enabled at build time (e.g. -DBENCH_ENABLE=1) for
+///         development builds only.
+#ifndef BENCH_ENABLE
+#define BENCH_ENABLE        0
+#endif
+
+/// List of benchmarked calibration cases.
+typedef enum
+{
+    BENCH_CASE_SERVO,       ///< Servo position correction (Q30, every int16 command wrapped to +/-1.024rad).
+    BENCH_CASE_VSENSE,      ///< VSENSE correction (Q30, every 12-bit ADC count).
+
+    BENCH_CASE_NUM_OF
+
+} BENCH_CASE_E;
+
+/// List of benchmarked polynomial evaluators.
+///
+/// @note   The first evaluator is the reference against which the output of
+///         all evaluators is compared.
+typedef enum
+{
+    BENCH_EVAL_POW,         ///< Power-series evaluation (reference, former UtilPoly32).
+    BENCH_EVAL_POLY32,      ///< UtilPoly32 (Horner form, selected multiplication kernel).
+    BENCH_EVAL_POLY32_C,    ///< Horner form with portable 64-bit C multiplication.
+    BENCH_EVAL_POLY32_SPEC, ///< Specialized evaluator of the case (UTIL_POLY32_DEFINE).
+
+    BENCH_EVAL_NUM_OF
+
+} BENCH_EVAL_E;
+
+/// Number of benchmark results (one per case and evaluator).
+#if BENCH_ENABLE
+#define BENCH_RESULT_NUM_OF ( BENCH_CASE_NUM_OF * BENCH_EVAL_NUM_OF )
+#else
+#define BENCH_RESULT_NUM_OF 0U
+#endif
+
+/// Benchmark result of an evaluator for a calibration case.
+typedef struct
+{
+    uint16_t cyc_mean;  ///< Mean execution time (LSB = 1 instruction cycle).
+    uint16_t cyc_max;   ///< Maximum execution time (LSB = 1 instruction cycle).
+    uint16_t err_max;   ///< Maximum absolute difference from the reference evaluator (LSB = 1 output LSB).
+
+} BENCH_RESULT_S;
+
+// *****************************************************************************
+// ************************** Declarations *************************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Perform the calibration math benchmark.
+///
+/// Each evaluator is executed over the input range of each calibration case,
+/// using the configured calibration coefficients.
+///
+/// @note   Function must be executed before interrupts are enabled, so that
+///         execution time measurements are not affected by preemption.
+///
+/// @note   Function is only defined if BENCH_ENABLE is set.
+////////////////////////////////////////////////////////////////////////////////
+#if BENCH_ENABLE
+void BenchRun ( void );
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return a benchmark result.
+///
+/// @param  result_idx
+///             The result index (case * BENCH_EVAL_NUM_OF + evaluator).
+/// @param  result
+///             Buffer for storing the result.
+///
+/// @note   If BENCH_ENABLE is not set, there are no results and the result
+///         is cleared.
+////////////////////////////////////////////////////////////////////////////////
+void BenchResultGet ( uint8_t result_idx, BENCH_RESULT_S* result );
+
+#endif	// BENCH_H_
\ No newline at end of file
@@ -32,11 +32,26 @@ typedef enum
     CAN_TX_MSG_NODE_VER,
     CAN_TX_MSG_CFG_WRITE_RESP,
     CAN_TX_MSG_CFG_READ_RESP,
+    CAN_TX_MSG_DIAG_DATA,
+    CAN_TX_MSG_SERVO_POS,
     
     CAN_TX_MSG_NUM_OF
     
 } CAN_TX_MSG_TYPE_E;
 
+/// List of transmit priorities, in order of decreasing priority.
+///
+/// @note   Each priority has a transmit queue.
+typedef enum
+{
+    CAN_TX_PRIO_HIGH,   ///< Servo Status, VSENSE Data, Servo Position.
+    CAN_TX_PRIO_MID,    ///< Node Status, Node Version.
+    CAN_TX_PRIO_LOW,    ///< Configuration responses, Diagnostics Data.
+    
+    CAN_TX_PRIO_NUM_OF
+    
+} CAN_TX_PRIO_E;
+
 /// List of received messages.
 typedef enum
 {
@@ -67,6 +82,19 @@ typedef union
     
 } CAN_TX_SERVO_STATUS_U;
 
+/// Payload content of Servo Position message.
+typedef union
+{
+    uint16_t data_u16[ 4 ];
+    
+    struct
+    {
+        int16_t  pos_est;   ///< Estimated position (LSB = 0.001rad, 0x8000 = not available).
+        uint16_t pwm_act;
+    };
+    
+} CAN_TX_SERVO_POS_U;
+
 /// Payload content of VSENSE Data message.
 typedef union
 {
@@ -143,6 +171,85 @@ typedef union
     
 } CAN_TX_READ_RESP_U;
 
+/// Payload content of Diagnostics Data message.
+typedef union
+{
+    uint16_t data_u16[ 4 ];
+    
+    struct
+    {
+        uint16_t diag_sel;
+        
+        union
+        {
+            // Profiled service execution time.
+            struct
+            {
+                uint16_t cyc_min;
+                uint16_t cyc_max;
+                uint16_t cyc_mean;
+            };
+            
+            // Executive load.
+            struct
+            {
+                uint16_t overrun_cnt;
+                uint16_t cpu_load;
+                uint16_t cycle_time_max;
+            };
+            
+            // Servo correction result cache.
+            struct
+            {
+                uint16_t memo_hit_cnt;
+                uint16_t memo_miss_cnt;
+                uint16_t cmd_latency_max;
+            };
+            
+            // CAN receive queue overflow.
+            struct
+            {
+                uint16_t rx_ovf_cnt[ 3 ];
+            };
+            
+            // CAN transmit queue dropped messages.
+            struct
+            {
+                uint16_t tx_drop_cnt[ CAN_TX_PRIO_NUM_OF ];
+            };
+            
+            // CAN transmit queue high-water marks.
+            struct
+            {
+                uint16_t tx_hwm[ CAN_TX_PRIO_NUM_OF ];
+            };
+            
+            // CAN bit rate.
+            struct
+            {
+                uint16_t bitrate_cfg;
+                uint16_t bitrate_act;
+            };
+            
+            // CAN receive FIFO events.
+            struct
+            {
+                uint16_t fifo_full_cnt;
+                uint16_t fifo_ovf_cnt;
+            };
+            
+            // Calibration math benchmark result.
+            struct
+            {
+                uint16_t bench_cyc_mean;
+                uint16_t bench_cyc_max;
+                uint16_t bench_err_max;
+            };
+        };
+    };
+    
+} CAN_TX_DIAG_DATA_U;
+
 //
 // RECEIVE MESSAGES -----------------------------------------------------------
 //
@@ -203,22 +310,120 @@ typedef union
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Initialize CAN hardware.
+///
+/// The configured bit rate is applied, or if auto-baud is enabled, the bit 
+/// rate of the bus traffic (see CfgCANAutoBaudGet).
 ////////////////////////////////////////////////////////////////////////////////
 void CANInit ( void );
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the applied CAN bit rate.
+///
+/// @return The bit rate selected by CANInit.  The value is the enumeration
+///         value of CFG_BITRATE_E.
+////////////////////////////////////////////////////////////////////////////////
+uint8_t CANBitrateGet ( void );
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Queue CAN message for transmission.
 ///
+/// The message is added to the transmit queue of the message type's priority.
+/// If the queue is full, the message is discarded and counted as dropped.
+///
 /// @param  tx_msg_type
 ///             Type of message transmitted.
 /// @param  payload
 ///             Payload of message to transmit.
+///
+/// @note   Function is executed by the software cycle only (i.e. the single
+///         producer of the transmit queues).
 ////////////////////////////////////////////////////////////////////////////////
 void CANTxSet ( CAN_TX_MSG_TYPE_E tx_msg_type, const uint16_t payload[ 4 ] );
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Reserve a transmit queue entry for a CAN message.
+///
+/// The payload is written in place to the returned entry, and the message is
+/// queued for transmission by CANTxCommit.  If the queue is full, the message
+/// is counted as dropped.
+///
+/// @param  tx_msg_type
+///             Type of message transmitted.
+///
+/// @return Payload (4 words) of the reserved entry, or NULL if the transmit
+///         queue is full.
+///
+/// @note   Only one entry of each priority may be reserved at a time (i.e.
+///         the entry must be committed before the next message of the 
+///         priority is acquired).  Function is executed by the software
+///         cycle only - see CANTxSet.
+////////////////////////////////////////////////////////////////////////////////
+uint16_t* CANTxAcquire ( CAN_TX_MSG_TYPE_E tx_msg_type );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Queue a reserved CAN message for transmission.
+///
+/// @param  tx_msg_type
+///             Type of message transmitted (as supplied to CANTxAcquire).
+///
+/// @note   Function must only be executed if CANTxAcquire returned an entry.
+////////////////////////////////////////////////////////////////////////////////
+void CANTxCommit ( CAN_TX_MSG_TYPE_E tx_msg_type );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Determine if a CAN message can be queued for transmission.
+///
+/// @param  tx_msg_type
+///             Type of message transmitted.
+///
+/// @return true  - a message of the type is queued by CANTxSet.  
+///         false - a message of the type is discarded by CANTxSet (i.e. the
+///                 transmit queue of the type's priority is full).
+////////////////////////////////////////////////////////////////////////////////
+bool CANTxFreeGet ( CAN_TX_MSG_TYPE_E tx_msg_type );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Determine the number of CAN messages which can be queued for 
+///         transmission.
+///
+/// @param  tx_msg_type
+///             Type of message transmitted.
+///
+/// @return The number of free entries of the transmit queue of the type's
+///         priority (i.e. 0 to the transmit queue length).
+///
+/// @note   The number is only reduced by queuing of messages of the 
+///         priority, and is increased by the CAN interrupt.
+////////////////////////////////////////////////////////////////////////////////
+uint8_t CANTxFreeCntGet ( CAN_TX_MSG_TYPE_E tx_msg_type );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Service the CAN transmit interrupt - move queued messages to free
+///         transmit buffers.
+///
+/// @note   Function is executed by the CAN interrupt, following CANRxService
+///         (which clears the interrupt flags).
+////////////////////////////////////////////////////////////////////////////////
+void CANTxService ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the transmit queue counters of a priority.
+///
+/// @param  prio
+///             The transmit priority.
+/// @param  drop_cnt
+///             Buffer for storing the number of messages discarded because 
+///             the queue was full (saturated at maximum value).
+/// @param  hwm
+///             Buffer for storing the maximum number of queued messages.
+////////////////////////////////////////////////////////////////////////////////
+void CANTxQueueCntGet ( CAN_TX_PRIO_E prio, uint16_t* drop_cnt, uint8_t* hwm );
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Read received CAN message.
 ///
+/// The oldest message of the type is removed from the type's receive queue.
+///
 /// @param  rx_msg_type
 ///             Type of message received.
 /// @param  payload
@@ -226,7 +431,81 @@ void CANTxSet ( CAN_TX_MSG_TYPE_E tx_msg_type, const uint16_t payload[ 4 ] );
 ///
 /// @return true  - returned data is value.  
 ///         false - returned data is invalid.
+///
+/// @note   Each message type must be read by a single thread only.
 ////////////////////////////////////////////////////////////////////////////////
 bool CANRxGet ( CAN_RX_MSG_TYPE_E rx_msg_type, uint16_t payload[ 4 ] );
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the reception time of the last read CAN message.
+///
+/// @param  rx_msg_type
+///             Type of message received.
+///
+/// @return The reception time (LSB = 1 instruction cycle, see TMRTickGet) of
+///         the message last returned by CANRxGet for the type.
+///
+/// @note   The reception time is that of the CAN receive interrupt which 
+///         queued the message.
+////////////////////////////////////////////////////////////////////////////////
+uint32_t CANRxTickGet ( CAN_RX_MSG_TYPE_E rx_msg_type );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the number of lost CAN messages.
+///
+/// @param  rx_msg_type
+///             Type of message received.
+///
+/// @return The number of messages of the type lost because the receive 
+///         queue or a receive buffer was full (saturated at maximum value).
+////////////////////////////////////////////////////////////////////////////////
+uint16_t CANRxOvfCntGet ( CAN_RX_MSG_TYPE_E rx_msg_type );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the receive FIFO event counters.
+///
+/// The receive FIFO stores the Configuration Write and Read requests.
+///
+/// @param  full_cnt
+///             Buffer for storing the number of FIFO almost full events.
+/// @param  ovf_cnt
+///             Buffer for storing the number of messages lost because the
+///             FIFO was full.
+///
+/// @note   Counters are saturated at maximum value.
+////////////////////////////////////////////////////////////////////////////////
+void CANRxFifoCntGet ( uint16_t* full_cnt, uint16_t* ovf_cnt );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Service the CAN receive interrupt - queue received messages.
+///
+/// Interrupt flags are cleared, and each received message is moved from its
+/// receive buffer to the receive queue of its type.
+///
+/// @note   Flags are cleared before received messages are read, so that a
+///         message received while reading sets the flags again (i.e. the 
+///         message is not missed).
+////////////////////////////////////////////////////////////////////////////////
+void CANRxService ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Enable the CAN1 interrupt.
+////////////////////////////////////////////////////////////////////////////////
+void CANIntEnable ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Disable the CAN1 interrupt.
+///
+/// The CAN1 interrupt services both reception and transmission; while 
+/// disabled, received messages (including Servo Commands) are not processed
+/// and queued messages are not moved to the transmit buffers.
+///
+/// @note   Messages received while disabled are retained in the receive
+///         buffers and the interrupt flag remains set, so that the messages 
+///         are serviced when the interrupt is enabled.  Messages queued while
+///         disabled set the interrupt flag (see CANTxCommit), so that they 
+///         are transmitted when the interrupt is enabled.
+////////////////////////////////////////////////////////////////////////////////
+void CANIntDisable ( void );
+
 #endif	// CAN_H_
\ No newline at end of file
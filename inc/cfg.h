@@ -19,6 +19,8 @@
 // ************************** User Include Files *******************************
 // *****************************************************************************
 
+#include "util.h"
+
 // *****************************************************************************
 // ************************** Defines ******************************************
 // *****************************************************************************
@@ -26,6 +28,31 @@
 #define CFG_PWM_COEFF_LEN       6   ///< Number of PWM coefficients.
 #define CFG_VSENSE1_COEFF_LEN   6   ///< Number of VSENSE1 coefficients.
 #define CFG_VSENSE2_COEFF_LEN   6   ///< Number of VSENSE2 coefficients.
+#define CFG_PWM_PWL_LEN        16   ///< Number of PWM piecewise-linear breakpoints.
+
+/// List of calibration types.
+typedef enum
+{
+    CFG_CAL_POLY,       ///< Polynomial (coefficients).
+    CFG_CAL_PWL,        ///< Piecewise-linear (breakpoints).
+
+    CFG_CAL_NUM_OF
+
+} CFG_CAL_E;
+
+/// List of CAN bit rates.
+///
+/// @note   The enumeration value is the configuration data value.
+typedef enum
+{
+    CFG_BITRATE_1M,     ///< 1Mbps.
+    CFG_BITRATE_500K,   ///< 500kbps.
+    CFG_BITRATE_250K,   ///< 250kbps.
+    CFG_BITRATE_125K,   ///< 125kbps.
+
+    CFG_BITRATE_NUM_OF
+
+} CFG_BITRATE_E;
 
 // *****************************************************************************
 // ************************** Declarations *************************************
@@ -35,11 +62,35 @@
 // ************************** Function Prototypes ******************************
 // *****************************************************************************
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Initialize the RAM copy of the configuration data.
+///
+/// @note   Function must be executed before any other configuration data
+///         access (e.g. before CAN initialization, which uses the node ID).
+////////////////////////////////////////////////////////////////////////////////
+void CfgInit ( void );
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Service configuration read/write messages.
 ////////////////////////////////////////////////////////////////////////////////
 void CfgService ( void );
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the configuration data generation.
+///
+/// @return The generation of the configuration data (16-bit roll-over 
+///         counter).
+///
+/// @note   The generation is changed each time the configuration data is 
+///         updated.  Consumers which derive data from the configuration 
+///         data can compare the generation to that of the derived data, 
+///         rather than comparing the configuration data itself.
+///
+/// @note   The generation is never 0, so that 0 can be used by consumers to
+///         identify derived data which has not been determined.
+////////////////////////////////////////////////////////////////////////////////
+uint16_t CfgGenGet ( void );
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Get the configuration node ID.
 ///
@@ -47,25 +98,81 @@ void CfgService ( void );
 ////////////////////////////////////////////////////////////////////////////////
 uint8_t CfgNodeIdGet ( void );
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the configured CAN bit rate.
+///
+/// @return The CAN bit rate.  An invalid configuration data value selects 
+///         1Mbps.
+///
+/// @note   The bit rate is applied by CANInit (i.e. an update is applied at
+///         the next reset).
+////////////////////////////////////////////////////////////////////////////////
+CFG_BITRATE_E CfgCANBitrateGet ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the CAN auto-baud enable.
+///
+/// @return true  - the bit rate is determined from bus traffic at startup.  
+///         false - the configured bit rate is used.
+////////////////////////////////////////////////////////////////////////////////
+bool CfgCANAutoBaudGet ( void );
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Get the PWM coefficients.
-/// @param  pwm_coeff
-///             Buffer to copy the PWM coefficients into.
+///
+/// @return Pointer to the CFG_PWM_COEFF_LEN PWM coefficients (read-only).
+///
+/// @note   The coefficients are updated with the configuration data (see
+///         CfgGenGet).
 ////////////////////////////////////////////////////////////////////////////////
-void CfgPWMCoeffGet ( int32_t pwm_coeff[ CFG_PWM_COEFF_LEN ] );
+const int32_t* CfgPWMCoeffGet ( void );
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Get the VSENSE1 coefficients.
-/// @param  vsense1_coeff
-///             Buffer to copy the VSENSE1 coefficients into.
+///
+/// @return Pointer to the CFG_VSENSE1_COEFF_LEN VSENSE1 coefficients 
+///         (read-only).
+///
+/// @note   The coefficients are updated with the configuration data (see
+///         CfgGenGet).
 ////////////////////////////////////////////////////////////////////////////////
-void CfgVsense1CoeffGet ( int32_t vsense1_coeff[ CFG_VSENSE1_COEFF_LEN ] );
+const int32_t* CfgVsense1CoeffGet ( void );
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Get the VSENSE2 coefficients.
-/// @param  vsense2_coeff
-///             Buffer to copy the VSENSE2 coefficients into.
+///
+/// @return Pointer to the CFG_VSENSE2_COEFF_LEN VSENSE2 coefficients 
+///         (read-only).
+///
+/// @note   The coefficients are updated with the configuration data (see
+///         CfgGenGet).
+////////////////////////////////////////////////////////////////////////////////
+const int32_t* CfgVsense2CoeffGet ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the PWM calibration type.
+///
+/// @return The calibration type applied to the servo position command.
+///
+/// @note   The polynomial calibration is returned if the piecewise-linear
+///         calibration is configured but its breakpoints are invalid (see 
+///         UtilPwlInit).
+///
+/// @note   The calibration type is updated with the configuration data (see
+///         CfgGenGet).
+////////////////////////////////////////////////////////////////////////////////
+CFG_CAL_E CfgPWMCalTypeGet ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the PWM piecewise-linear calibration curve.
+///
+/// @return Pointer to the curve (read-only).  The breakpoint inputs are the
+///         position command (LSB = 0.001rad), and the outputs have the same
+///         scaling as the PWM polynomial output (LSB = 0.01us).
+///
+/// @note   The curve is updated with the configuration data (see 
+///         CfgGenGet).
 ////////////////////////////////////////////////////////////////////////////////
-void CfgVsense2CoeffGet ( int32_t vsense2_coeff[ CFG_VSENSE2_COEFF_LEN ] );
+const UTIL_PWL_S* CfgPWMPwlGet ( void );
 
 #endif	// CFG_H_
\ No newline at end of file
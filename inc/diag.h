@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Executive diagnostics.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DIAG_H_
+#define	DIAG_H_
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <xc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+/// List of profiled software services.
+///
+/// @note   The enumeration value is annunciated as the diagnostic selection
+///         of the Diagnostics Data CAN message.
+///
+/// @note   DIAG_SVC_SERVO_ISR is the application of servo commands by the
+///         CAN1 interrupt (see DiagIsrMark).  The other services are
+///         executed by the software cycle.
+typedef enum
+{
+    DIAG_SVC_ADC,
+    DIAG_SVC_INA219,
+    DIAG_SVC_WDT,
+    DIAG_SVC_VSENSE,
+    DIAG_SVC_CFG,
+    DIAG_SVC_RST,
+    DIAG_SVC_VER,
+    DIAG_SVC_SERVO_STATUS,
+    DIAG_SVC_DIAG,
+    DIAG_SVC_SERVO_LUT,
+    DIAG_SVC_SERVO_ISR,
+
+    DIAG_SVC_NUM_OF
+
+} DIAG_SVC_E;
+
+/// List of annunciated diagnostic records.
+///
+/// @note   Records are annunciated with a diagnostic selection of 
+///         DIAG_REC_SEL_BASE plus the enumeration value.  This separates
+///         the record selections from the profiled service selections.
+typedef enum
+{
+    DIAG_REC_LOAD,      ///< Executive load (overrun count, CPU load, cycle time).
+    DIAG_REC_SERVO_MEMO,///< Servo correction result cache (hit count, miss count) and maximum command latency.
+    DIAG_REC_CAN_RX,    ///< CAN receive lost messages (servo command, cfg write, cfg read count).
+    DIAG_REC_CAN_FIFO,  ///< CAN receive FIFO (almost full count, lost message count).
+    DIAG_REC_CAN_TX_DROP,   ///< CAN transmit queue dropped messages (high, mid, low priority count).
+    DIAG_REC_CAN_TX_HWM,    ///< CAN transmit queue high-water mark (high, mid, low priority).
+    DIAG_REC_CAN_BITRATE,   ///< CAN bit rate (configured, applied - see CFG_BITRATE_E).
+
+    DIAG_REC_NUM_OF
+
+} DIAG_REC_E;
+
+#define DIAG_REC_SEL_BASE   0x80U   ///< Diagnostic selection of the first record.
+#define DIAG_BENCH_SEL_BASE 0xC0U   ///< Diagnostic selection of the first benchmark result (see bench.h).
+
+// *****************************************************************************
+// ************************** Declarations *************************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Start execution time measurement of the software cycle.
+///
+/// @note   Function is executed at the start of the software cycle, before
+///         any profiled service is executed.
+////////////////////////////////////////////////////////////////////////////////
+void DiagFrameStart ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Record execution time of a software service.
+///
+/// The time elapsed since the previous mark (or the start of the software
+/// cycle) is attributed to the selected service.
+///
+/// @param  svc
+///             The service which completed execution.
+////////////////////////////////////////////////////////////////////////////////
+void DiagMark ( DIAG_SVC_E svc );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Record execution time of a service executed by an interrupt.
+///
+/// The time elapsed since the start of the service is attributed to the
+/// selected service.  The mark of the software cycle (see DiagMark) is not
+/// affected.
+///
+/// @param  svc
+///             The service which completed execution.
+/// @param  start_cyc
+///             The cycle counter value at the start of the service (see
+///             TMRTickGet).
+///
+/// @note   Function is only executed by interrupts of higher priority than
+///         the software cycle.
+////////////////////////////////////////////////////////////////////////////////
+void DiagIsrMark ( DIAG_SVC_E svc, uint32_t start_cyc );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Complete execution time measurement of the software cycle.
+///
+/// Overrun of the software cycle is detected and the software cycle execution
+/// time and background thread execution are accumulated.
+///
+/// @note   Function is executed at the end of the software cycle, after the
+///         Timer1 interrupt flag was serviced at the start of the cycle.
+////////////////////////////////////////////////////////////////////////////////
+void DiagFrameEnd ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Calibrate the background thread execution rate.
+///
+/// The background thread is executed for one software cycle period to
+/// determine the number of iterations performed when no software cycle 
+/// processing is performed (i.e. 0% CPU load).  The period is timed by the
+/// Timer4 one-shot interrupt, which terminates the background thread 
+/// processing (see DiagIdleStop).
+///
+/// @note   Function must be executed before the software cycle processing is
+///         started (i.e. before enabling of Timer1), and with global 
+///         interrupts enabled.
+////////////////////////////////////////////////////////////////////////////////
+void DiagIdleCalibrate ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Terminate the background thread calibration.
+///
+/// @note   Function is executed by the Timer4 one-shot interrupt.
+////////////////////////////////////////////////////////////////////////////////
+void DiagIdleStop ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Background thread processing - count thread iterations.
+///
+/// Thread iterations are counted until terminated by DiagIdleStop, which is
+/// performed only during calibration (see DiagIdleCalibrate).
+///
+/// @note   Function is executed in the background thread infinite-loop.
+////////////////////////////////////////////////////////////////////////////////
+void DiagIdle ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Annunciate execution time measurements on CAN.
+///
+/// @note   A diagnostic is not annunciated while the low priority transmit
+///         queue is full (i.e. it is annunciated on a later execution), so
+///         that it is not dropped by the queue.
+////////////////////////////////////////////////////////////////////////////////
+void DiagService ( void );
+
+#endif	// DIAG_H_
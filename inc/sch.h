@@ -0,0 +1,47 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Software cycle task scheduler.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SCH_H_
+#define	SCH_H_
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <xc.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** Declarations *************************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Initialize the task scheduler.
+///
+/// @note   Function must be executed before the software cycle processing is
+///         started (i.e. before enabling of Timer1).
+////////////////////////////////////////////////////////////////////////////////
+void SchInit ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Execute the tasks scheduled for the software cycle.
+////////////////////////////////////////////////////////////////////////////////
+void SchService ( void );
+
+#endif	// SCH_H_
\ No newline at end of file
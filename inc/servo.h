@@ -23,6 +23,34 @@
 // ************************** Defines ******************************************
 // *****************************************************************************
 
+/// Servo calibration lookup table enable.
+///
+/// @note   When enabled, the servo position correction is performed by 
+///         linear interpolation of a table of the correction polynomial, 
+///         rather than evaluation of the polynomial on each command.  The 
+///         table is built from the configured coefficients at startup and 
+///         whenever the coefficients change.
+#ifndef SERVO_LUT_ENABLE
+#define SERVO_LUT_ENABLE        0
+#endif
+
+/// Servo calibration lookup table size - the position range is divided into
+/// 2^SERVO_LUT_SIZE_LOG2 segments (i.e. the table has 2^n + 1 entries of 4
+/// bytes).
+///
+/// @note   Interpolation error reduces by a factor of 4 for each increment
+///         of the table size (i.e. RAM is traded against accuracy).  The
+///         error of each segment is bounded by h^2 / 8 * max|f''|, where h is
+///         the segment width (2.048rad / 2^n) and f'' is the second 
+///         derivative of the correction polynomial over the segment.
+#ifndef SERVO_LUT_SIZE_LOG2
+#define SERVO_LUT_SIZE_LOG2     7
+#endif
+
+#if ( SERVO_LUT_SIZE_LOG2 < 1 ) || ( SERVO_LUT_SIZE_LOG2 > 11 )
+#error "SERVO_LUT_SIZE_LOG2 must be within 1-11."
+#endif
+
 // *****************************************************************************
 // ************************** Declarations *************************************
 // *****************************************************************************
@@ -32,8 +60,61 @@
 // *****************************************************************************
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief  Control the servo and annunciate operation on CAN.
+/// @brief  Control the servo with the received Servo Command.
+///
+/// @note   Function is executed on reception of a Servo Command message (i.e.
+///         from the CAN receive interrupt), so that the commanded value is
+///         applied to the PWM output without waiting for the software cycle.
 ////////////////////////////////////////////////////////////////////////////////
 void ServoService ( void );
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Annunciate servo operation on CAN.
+///
+/// The Servo Status message and the Servo Position message are sent.  The 
+/// Servo Position message annunciates the position estimated from the
+/// applied PWM by the inverse of the servo calibration.
+////////////////////////////////////////////////////////////////////////////////
+void ServoStatusService ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the position correction result cache counters.
+///
+/// A position command equal to the previous one (with unchanged 
+/// configuration data) uses the previous correction result rather than 
+/// performing the correction.
+///
+/// @param  hit_cnt
+///             Buffer for the number of commands which used the previous 
+///             result (16-bit roll-over counter).
+/// @param  miss_cnt
+///             Buffer for the number of commands for which correction was
+///             performed (16-bit roll-over counter).
+////////////////////////////////////////////////////////////////////////////////
+void ServoMemoCntGet ( uint16_t* hit_cnt, uint16_t* miss_cnt );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Get the maximum Servo Command latency.
+///
+/// @return The maximum time from the queuing of a Servo Command by the CAN
+///         receive interrupt to its application to the PWM output (LSB = 1
+///         instruction cycle, saturated at maximum value).
+///
+/// @note   The maximum is cumulative (i.e. not cleared on reading), since it
+///         is updated by the CAN receive interrupt.
+////////////////////////////////////////////////////////////////////////////////
+uint16_t ServoLatencyMaxGet ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Build the servo calibration lookup table.
+///
+/// The coefficients are checked for change and the table is built over
+/// successive executions, so that the execution time of each software cycle
+/// is bounded.  Servo position correction is performed by evaluation of the
+/// polynomial until the table is complete.
+///
+/// @note   Function performs no processing if SERVO_LUT_ENABLE is not set.
+////////////////////////////////////////////////////////////////////////////////
+void ServoLutService ( void );
+
 #endif	// SERVO_H_
\ No newline at end of file
@@ -23,6 +23,37 @@
 // ************************** Defines ******************************************
 // *****************************************************************************
 
+/// Software cycle (i.e. executive frame) period in micro-seconds.
+///
+/// @note   The period may be overridden at build time (e.g. 
+///         -DTMR_FRAME_PERIOD_US=2500U) to reduce the latency of software
+///         cycle processing.  Supported periods are 1ms, 2.5ms, 5ms, and
+///         10ms - each divides 10ms, so that all task periods expressed in
+///         multiples of 10ms are an integer number of software cycles.
+#ifndef TMR_FRAME_PERIOD_US
+#define TMR_FRAME_PERIOD_US 10000U
+#endif
+
+#if ( TMR_FRAME_PERIOD_US != 1000U ) && \
+    ( TMR_FRAME_PERIOD_US != 2500U ) && \
+    ( TMR_FRAME_PERIOD_US != 5000U ) && \
+    ( TMR_FRAME_PERIOD_US != 10000U )
+#error "TMR_FRAME_PERIOD_US must be one of 1000, 2500, 5000, or 10000."
+#endif
+
+#define TMR_CYC_PER_US         20U  ///< Instruction cycles per micro-second (Fcy = 20MHz).
+
+#define TMR1_PRESCALE           8U  ///< Timer1 clock prescale.
+
+/// Timer1 period (i.e. software cycle) in instruction cycles.
+#define TMR1_PERIOD_CYC     ( (uint32_t) TMR_FRAME_PERIOD_US * TMR_CYC_PER_US )
+
+/// Number of software cycles in a time period (LSB = 1ms).
+///
+/// @note   A time period which is not a multiple of the software cycle 
+///         period is truncated to a whole number of software cycles.
+#define TMR1_MS_TO_CYCLES( ms )     ( (uint16_t) ( ( (uint32_t) (ms) * 1000U ) / TMR_FRAME_PERIOD_US ) )
+
 // *****************************************************************************
 // ************************** Declarations *************************************
 // *****************************************************************************
@@ -54,15 +85,94 @@ void TMR1Disable ( void );
 void TMR1Service ( void );
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief  Service Timer2 - increment counter and clear interrupt flag.
+/// @brief  Return Timer1 counter.
+///
+/// @return The Timer1 counter value (LSB = TMR1_PRESCALE instruction cycles).
+///
+/// @note   The counter is cleared at the start of each Timer1 period.
+////////////////////////////////////////////////////////////////////////////////
+uint16_t TMR1Get ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return Timer1 interrupt flag.
+///
+/// @return true  - Timer1 period elapsed since the flag was last serviced.
+///         false - Timer1 period has not elapsed since the flag was last 
+///                 serviced.
 ////////////////////////////////////////////////////////////////////////////////
-void TMR2Service ( void );
+bool TMR1FlagGet ( void );
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief  Return Timer2 0.1ms counter.
+/// @brief  Start a Timer4 one-shot period.
+///
+/// The Timer4 interrupt is triggered once, after one software cycle period
+/// (TMR1_PERIOD_CYC) has elapsed.
+///
+/// @note   The interrupt is only serviced when global interrupts are enabled.
+////////////////////////////////////////////////////////////////////////////////
+void TMR4OneShotStart ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Service Timer4 - clear interrupt flag and stop the one-shot period.
+////////////////////////////////////////////////////////////////////////////////
+void TMR4Service ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Service Timer2/3 - count the roll-over of the 32-bit instruction 
+///         cycle counter and clear interrupt flag.
+////////////////////////////////////////////////////////////////////////////////
+void TMR23Service ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return 0.1ms counter.
 ///
 /// @return The 0.1ms counter value.
+///
+/// @note   The counter is derived from the 32-bit instruction cycle counter
+///         (see TMRTickGet) extended by its roll-over count, so that the 
+///         counter rolls-over at its 16-bit limit (every ~6.5s).
 ////////////////////////////////////////////////////////////////////////////////
 uint16_t TMR2p1msGet ( void );
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return 32-bit instruction cycle counter.
+///
+/// @return The free-running cycle counter value (LSB = 1 instruction cycle).
+///
+/// @note   The counter is 32-bit and rolls-over every ~214.7s.  Elapsed time
+///         is determined by unsigned subtraction of two counter values, 
+///         which is valid for elapsed times less than the roll-over time.
+///
+/// @note   Function is thread-safe - interrupts are disabled while the 
+///         counter's two 16-bit words are read.
+////////////////////////////////////////////////////////////////////////////////
+uint32_t TMRTickGet ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return micro-second timestamp.
+///
+/// @return The micro-second timestamp (LSB = 1us).
+///
+/// @note   The timestamp is derived from the 32-bit instruction cycle counter
+///         (see TMRTickGet) extended by its roll-over count, so that the 
+///         timestamp rolls-over at its 32-bit limit (every ~71.6min).
+///
+/// @note   The timestamp is scaled by multiplication by a reciprocal (i.e.
+///         without division), but TMRTickGet is preferred where execution
+///         time is critical.
+////////////////////////////////////////////////////////////////////////////////
+uint32_t TMRUsGet ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return 16-bit instruction cycle counter.
+///
+/// @return The free-running cycle counter value (LSB = 1 instruction cycle).
+///
+/// @note   The counter is the low word of the 32-bit counter (see 
+///         TMRTickGet), and rolls-over every 3.2768ms.  Elapsed time is 
+///         determined by unsigned subtraction of two counter values, which is
+///         valid for elapsed times less than the roll-over time.
+////////////////////////////////////////////////////////////////////////////////
+uint16_t TMRCycleGet ( void );
+
 #endif	// TMR_H_
\ No newline at end of file
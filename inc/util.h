@@ -23,6 +23,79 @@
 // ************************** Defines ******************************************
 // *****************************************************************************
 
+/// Multiplication kernel selection of UtilPoly32.
+///
+/// When set, the 32x32-bit multiplications are composed of 16x16-bit
+/// hardware multiplications (XC16 __builtin_mulss/mulsu/muluu); otherwise
+/// portable 64-bit C multiplication is performed.  Both kernels produce
+/// bit-identical results.  The hardware kernel is selected by default when
+/// building for the target.
+#ifndef UTIL_MUL16_ENABLE
+#if defined( __XC16__ )
+#define UTIL_MUL16_ENABLE   1
+#else
+#define UTIL_MUL16_ENABLE   0
+#endif
+#endif
+
+/// Maximum number of breakpoints of a piecewise-linear curve.
+#define UTIL_PWL_LEN_MAX        16U
+
+/// Piecewise-linear curve.
+///
+/// @note   The segment slopes are determined from the breakpoints by 
+///         UtilPwlInit, so that evaluation requires one multiplication.
+typedef struct
+{
+    uint8_t len;                        ///< Number of breakpoints (0 = invalid curve).
+    int16_t x[ UTIL_PWL_LEN_MAX ];      ///< Breakpoint inputs (strictly increasing).
+    int32_t y[ UTIL_PWL_LEN_MAX ];      ///< Breakpoint outputs.
+    int32_t slope[ UTIL_PWL_LEN_MAX ];  ///< Slope of the segment following each breakpoint (Q16, output LSB per input LSB).
+
+} UTIL_PWL_S;
+
+/// Maximum number of coefficients of a specialized polynomial evaluator.
+#define UTIL_POLY32_LEN_MAX     8U
+
+/// Horner step of a specialized polynomial evaluator (see UTIL_POLY32_DEFINE).
+///
+/// The step is performed for coefficient 'idx' if the coefficient exists;
+/// the condition is a compile-time constant, so that steps beyond the number
+/// of coefficients are removed by the compiler.
+#define UTIL_POLY32_STEP( idx, calc_qnum, coeff_len )                          \
+    if( (idx) + 1U < (coeff_len) )                                             \
+    {                                                                          \
+        result = UtilMulQ32( result, var_in, (calc_qnum) ) + coeff[ (idx) ];   \
+    }
+
+/// Define a specialized polynomial evaluator.
+///
+/// A static function 'func_name( var_in, coeff )' is defined which computes
+/// the same result as UtilPoly32( var_in, calc_qnum, coeff, coeff_len ).  The
+/// number of coefficients and the Q-number are compile-time constants, so
+/// that the Horner loop is fully unrolled and the down-scaling shifts are
+/// constant.
+///
+/// @note   'coeff_len' must be within 1 to UTIL_POLY32_LEN_MAX (verified at
+///         compile time).
+#define UTIL_POLY32_DEFINE( func_name, calc_qnum, coeff_len )                  \
+    extern char func_name##_len_check[ ( ( (coeff_len) >= 1U ) &&             \
+                                         ( (coeff_len) <= UTIL_POLY32_LEN_MAX ) ) ? 1 : -1 ]; \
+    static int32_t func_name( int32_t var_in, const int32_t coeff[] )          \
+    {                                                                          \
+        int32_t result = coeff[ (coeff_len) - 1U ];                            \
+                                                                               \
+        UTIL_POLY32_STEP( 6U, calc_qnum, coeff_len )                           \
+        UTIL_POLY32_STEP( 5U, calc_qnum, coeff_len )                           \
+        UTIL_POLY32_STEP( 4U, calc_qnum, coeff_len )                           \
+        UTIL_POLY32_STEP( 3U, calc_qnum, coeff_len )                           \
+        UTIL_POLY32_STEP( 2U, calc_qnum, coeff_len )                           \
+        UTIL_POLY32_STEP( 1U, calc_qnum, coeff_len )                           \
+        UTIL_POLY32_STEP( 0U, calc_qnum, coeff_len )                           \
+                                                                               \
+        return result;                                                         \
+    }
+
 // *****************************************************************************
 // ************************** Declarations *************************************
 // *****************************************************************************
@@ -46,27 +119,213 @@
 /// @return The result of the polynomial computation.  Result is scaled by
 ///         same value as input 'coeff'.
 ///
-/// @note   Calculation can take considerable time depending on the degree of 
-///         the polynomial.  Fore example, the time required for computation 
-///         of 5th degree polynomial is approximately 0.5ms.
+/// @note   The polynomial is evaluated in Horner form - one 32x32-bit
+///         multiplication is performed per coefficient (after the first).
+///         See UTIL_MUL16_ENABLE for selection of the multiplication kernel.
+///
+/// @note   Each multiplication truncates the intermediate result by less than
+///         1 LSB (of the coefficient scale), which is propagated through the
+///         subsequent multiplications by the variable.  For a variable 
+///         magnitude of at most 1.0 the result is within ( coeff_len - 1 ) 
+///         LSB of the exact value; for the servo input range (+/-1.024) 
+///         the bound is ( coeff_len - 1 ) * 1.024^( coeff_len - 2 ) LSB.
 ////////////////////////////////////////////////////////////////////////////////
 int32_t UtilPoly32( int32_t var_in,
                     uint8_t calc_qnum,
-                    int32_t coeff[], 
+                    const int32_t coeff[], 
                     uint8_t coeff_len );
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Initialize a piecewise-linear curve from its breakpoints.
+///
+/// The breakpoints are validated and the segment slopes are determined.
+///
+/// @param  pwl
+///             The curve to initialize.
+/// @param  x
+///             Array of breakpoint inputs.
+/// @param  y
+///             Array of breakpoint outputs.
+/// @param  len
+///             Number of breakpoints.
+///
+/// @return Curve is valid (true) or invalid (false).  The curve is invalid
+///         if the number of breakpoints is not within 2 to UTIL_PWL_LEN_MAX,
+///         the breakpoint inputs are not strictly increasing, or a segment 
+///         slope exceeds the range of its representation.  The length of an
+///         invalid curve is set to 0.
+///
+/// @note   A 64-bit division is performed per segment; the function is 
+///         intended for execution on update of the breakpoints only.
+////////////////////////////////////////////////////////////////////////////////
+bool UtilPwlInit( UTIL_PWL_S* pwl,
+                  const int16_t x[],
+                  const int32_t y[],
+                  uint8_t len );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Piecewise-linear calculation of a 16-bit variable.
+///
+/// The segment containing the variable is determined by binary search of 
+/// the breakpoints, and the output is interpolated using the segment's 
+/// slope (one multiplication).
+///
+/// @param  var_in
+///             The input variable.
+/// @param  pwl
+///             The curve (valid - see UtilPwlInit).
+///
+/// @return The result of the piecewise-linear computation.  The output of
+///         the first (last) breakpoint is returned for inputs below (above)
+///         the range of the breakpoints.
+///
+/// @note   The result is within 2 LSB of the exact interpolation (truncation
+///         of the slope and of the interpolated term).
+////////////////////////////////////////////////////////////////////////////////
+int32_t UtilPwl( int16_t var_in, const UTIL_PWL_S* pwl );
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Delay specified amount of time.
 ///
 /// @param  ms_time
 ///             Number of milliseconds to delay.
 ///
-/// @note   Internal scaling by 10 is performed; therefore, input parameter 
-///         should not exceed 6553.
-///
-/// @note   Resolution of 0.1ms is achieved.  Therefore the time delayed by
-///         the function [ ms_time : ms_time+0.1 ].
+/// @note   Resolution of 1 instruction cycle is achieved.  Therefore the 
+///         time delayed by the function is at least ms_time (plus the 
+///         execution time of preempting interrupts).
 ////////////////////////////////////////////////////////////////////////////////
 void UtilDelay( uint16_t ms_time );
 
+// *****************************************************************************
+// ************************** Inline Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Q-number multiplication of 32-bit variables.
+///
+/// @param  var_a
+///             The first variable.
+/// @param  var_b
+///             The second variable.
+/// @param  qnum
+///             The Q-number by which the 64-bit product is down-scaled.
+///
+/// @return The 64-bit product shifted right by 'qnum' (i.e. rounded towards
+///         negative infinity), truncated to 32-bits.
+///
+/// @note   The hardware kernel (UTIL_MUL16_ENABLE) yields the same result as
+///         the 64-bit C multiplication, which XC16 performs by a library call.
+///
+/// @note   Function is defined in the header so that the Q-number of the
+///         specialized polynomial evaluators (UTIL_POLY32_DEFINE) is a
+///         compile-time constant.
+////////////////////////////////////////////////////////////////////////////////
+static inline int32_t UtilMulQ32( int32_t var_a, int32_t var_b, uint8_t qnum )
+{
+    int32_t  result;
+#if UTIL_MUL16_ENABLE
+    uint16_t a_lo;
+    int16_t  a_hi;
+    uint16_t b_lo;
+    int16_t  b_hi;
+    uint32_t mul_ll;
+    int32_t  mul_hl;
+    int32_t  mul_lh;
+    int32_t  mul_hh;
+    uint8_t  mid_shift;
+    uint32_t mid_mask;
+    uint32_t mid_rem;
+    
+    // Hardware kernel is applicable for the down-scaling of the middle
+    // partial products (i.e. 16 <= qnum <= 32) ?
+    if( ( qnum >= 16U ) && ( qnum <= 32U ) )
+    {
+        // Split the variables into 16-bit halves.
+        //
+        // Implementation defined behavior.  Shift operators retain the
+        // sign.
+        //
+        a_lo = (uint16_t) var_a;
+        a_hi = (int16_t) ( var_a >> 16 );
+        b_lo = (uint16_t) var_b;
+        b_hi = (int16_t) ( var_b >> 16 );
+        
+        // Compute the partial products - single-cycle hardware
+        // multiplications.
+        //
+        //  product = ( hh << 32 ) + ( ( hl + lh ) << 16 ) + ll
+        //
+        mul_ll = __builtin_muluu( a_lo, b_lo );
+        mul_hl = __builtin_mulsu( a_hi, b_lo );
+        mul_lh = __builtin_mulsu( b_hi, a_lo );
+        mul_hh = __builtin_mulss( a_hi, b_hi );
+        
+        // Down-scale the middle partial products separately, accumulating
+        // the truncated bits (and the carry from the low partial product) so
+        // that no precision is lost.
+        //
+        // Note: The sum of the middle partial products may exceed 32-bits,
+        // which is avoided by down-scaling before summation.
+        //
+        mid_shift = qnum - 16U;
+        mid_mask  = ( 1UL << mid_shift ) - 1U;
+        mid_rem   = ( (uint32_t) mul_hl & mid_mask ) +
+                    ( (uint32_t) mul_lh & mid_mask ) +
+                    ( mul_ll >> 16 );
+        
+        // Unsigned summation so that the 32-bit truncation is identical to
+        // that of the 64-bit multiplication.
+        result = (int32_t) ( ( (uint32_t) mul_hh << ( 32U - qnum ) ) +
+                             (uint32_t) ( mul_hl >> mid_shift ) +
+                             (uint32_t) ( mul_lh >> mid_shift ) +
+                             ( mid_rem >> mid_shift ) );
+    }
+    else
+#endif
+    {
+        // ~ 64-bit multiplication performed.
+        result = (int32_t) ( ( ( (int64_t) var_a ) * ( (int64_t) var_b ) ) >> qnum );
+    }
+    
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Division of a 32-bit variable by 100.
+///
+/// The division is performed by multiplication by the reciprocal, rather
+/// than by iterative division:
+///
+///     |dividend| / 100 = ( |dividend| >> 2 ) / 25
+///                      = ( ( |dividend| >> 2 ) * ceil( 2^32 / 25 ) ) >> 32
+///
+/// The reciprocal exceeds 2^32 / 25 by 4 / 25 (i.e. 4 / 2^32 per unit of
+/// the dividend), which does not alter the quotient for ( |dividend| >> 2 )
+/// less than 2^30 - i.e. for all 32-bit dividends.
+///
+/// @param  dividend
+///             The dividend.
+///
+/// @return The quotient, rounded towards zero - i.e. identical to the C
+///         division operator for all dividend values.
+////////////////////////////////////////////////////////////////////////////////
+static inline int32_t UtilDiv100( int32_t dividend )
+{
+    uint32_t dividend_abs;
+    int32_t  result;
+    
+    // Note: The magnitude of the minimum dividend (2^31) is represented by
+    // the unsigned type.
+    dividend_abs = ( dividend < 0 ) ? ( 0U - (uint32_t) dividend ) : (uint32_t) dividend;
+    
+    result = UtilMulQ32( (int32_t) ( dividend_abs >> 2 ), 171798692L, 32U );
+    
+    if( dividend < 0 )
+    {
+        result = -result;
+    }
+    
+    return result;
+}
+
 #endif	// UTIL_H_
\ No newline at end of file
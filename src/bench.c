@@ -0,0 +1,374 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Calibration math benchmark.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "bench.h"
+#include "cfg.h"
+#include "tmr.h"
+#include "util.h"
+#include "wdt.h"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#if BENCH_ENABLE
+
+#define BENCH_SERVO_SWEEP_LEN   65536UL ///< Number of servo inputs evaluated (every int16 position command).
+#define BENCH_VSENSE_SWEEP_LEN  4096UL  ///< Number of VSENSE inputs evaluated (every 12-bit ADC count).
+
+/// Polynomial evaluator function (see UtilPoly32 for parameters).
+typedef int32_t (*BENCH_EVAL_F)( int32_t var_in,
+                                 uint8_t calc_qnum,
+                                 const int32_t coeff[],
+                                 uint8_t coeff_len );
+
+/// Definition of a benchmarked calibration case.
+typedef struct
+{
+    const int32_t* (*coeff_get)( void );        ///< Coefficient accessor.
+    uint8_t coeff_len;                          ///< Number of coefficients.
+    uint8_t calc_qnum;                          ///< Polynomial calculation Q-number.
+    uint32_t sweep_len;                         ///< Number of inputs evaluated.
+    int32_t (*var_get)( uint32_t sweep_idx );   ///< Input for a sweep index.
+    int32_t (*spec_eval)( int32_t var_in,       ///< Specialized evaluator.
+                          const int32_t coeff[] );
+
+} BENCH_CASE_S;
+
+#endif
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+#if BENCH_ENABLE
+
+/// Benchmark results.
+static BENCH_RESULT_S bench_result[ BENCH_CASE_NUM_OF ][ BENCH_EVAL_NUM_OF ];
+
+#endif
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+#if BENCH_ENABLE
+
+static int32_t BenchPoly32Pow( int32_t var_in,
+                               uint8_t calc_qnum,
+                               const int32_t coeff[],
+                               uint8_t coeff_len );
+static int32_t BenchPoly32C( int32_t var_in,
+                             uint8_t calc_qnum,
+                             const int32_t coeff[],
+                             uint8_t coeff_len );
+static int32_t BenchServoVarGet( uint32_t sweep_idx );
+static int32_t BenchVsenseVarGet( uint32_t sweep_idx );
+static void BenchCaseRun( const BENCH_CASE_S* bench_case,
+                          BENCH_RESULT_S result[ BENCH_EVAL_NUM_OF ] );
+
+/// Specialized polynomial evaluators of the calibration cases.
+UTIL_POLY32_DEFINE( BenchServoPoly,  30U, CFG_PWM_COEFF_LEN )
+UTIL_POLY32_DEFINE( BenchVsensePoly, 30U, CFG_VSENSE1_COEFF_LEN )
+
+#endif
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+#if BENCH_ENABLE
+void BenchRun ( void )
+{
+    // Definition of the benchmarked calibration cases.
+    static const BENCH_CASE_S bench_case[ BENCH_CASE_NUM_OF ] =
+    {
+        { CfgPWMCoeffGet,     CFG_PWM_COEFF_LEN,     30U, BENCH_SERVO_SWEEP_LEN,  BenchServoVarGet,  BenchServoPoly  },  // BENCH_CASE_SERVO
+        { CfgVsense1CoeffGet, CFG_VSENSE1_COEFF_LEN, 30U, BENCH_VSENSE_SWEEP_LEN, BenchVsenseVarGet, BenchVsensePoly },  // BENCH_CASE_VSENSE
+    };
+
+    BENCH_CASE_E case_idx;
+
+    for( case_idx = (BENCH_CASE_E) 0;
+         case_idx < BENCH_CASE_NUM_OF;
+         case_idx++ )
+    {
+        BenchCaseRun( &bench_case[ case_idx ], &bench_result[ case_idx ][ 0 ] );
+    }
+}
+#endif
+
+void BenchResultGet ( uint8_t result_idx, BENCH_RESULT_S* result )
+{
+#if BENCH_ENABLE
+    *result = bench_result[ result_idx / BENCH_EVAL_NUM_OF ]
+                          [ result_idx % BENCH_EVAL_NUM_OF ];
+#else
+    // No benchmark is performed.
+    (void) result_idx;
+
+    result->cyc_mean = 0;
+    result->cyc_max  = 0;
+    result->err_max  = 0;
+#endif
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+#if BENCH_ENABLE
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Polynomial calculation by power-series evaluation (reference).
+///
+/// Each power term of the variable is computed by repeated multiplication
+/// and multiplied by its coefficient.  This is the former implementation of
+/// UtilPoly32, retained as the reference for comparison of evaluators.
+///
+/// @note   See UtilPoly32 for parameters and return value.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t BenchPoly32Pow( int32_t var_in,
+                               uint8_t calc_qnum,
+                               const int32_t coeff[],
+                               uint8_t coeff_len )
+{
+    int32_t result = 0;
+    int32_t var_term;
+    int64_t intermediate_mul;
+    uint8_t coeff_idx;
+    uint8_t pow_idx;
+    
+    for ( coeff_idx = 0;
+          coeff_idx < coeff_len;
+          coeff_idx++ )
+    {
+        // Calculate the variable power value.
+        // ~ scale = calc_qnum
+        var_term = 1L << calc_qnum;
+        
+        for( pow_idx = 0;
+             pow_idx < coeff_idx;
+             pow_idx++ )
+        {
+            // Note: The 1st power term is the variable itself (i.e. no
+            // truncation), as performed by the former implementation.
+            if( pow_idx == 0 )
+            {
+                var_term = var_in;
+            }
+            else
+            {
+                intermediate_mul = ((int64_t) var_term) * ((int64_t) var_in);
+                var_term         = (int32_t) (intermediate_mul >> calc_qnum);
+            }
+        }
+        
+        // Calculate the polynomial term and update the result.
+        // ~ scale = coeff_scale
+        intermediate_mul = ((int64_t) var_term) * ((int64_t) coeff[ coeff_idx ]);
+        result          += (int32_t) (intermediate_mul >> calc_qnum);
+    }
+    
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Polynomial calculation in Horner form by portable 64-bit C
+///         multiplication.
+///
+/// This is UtilPoly32 without the hardware multiplication kernel (see
+/// UTIL_MUL16_ENABLE).  The kernels are bit-identical, so the error of both
+/// evaluators is equal; the execution times are compared.
+///
+/// @note   See UtilPoly32 for parameters and return value.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t BenchPoly32C( int32_t var_in,
+                             uint8_t calc_qnum,
+                             const int32_t coeff[],
+                             uint8_t coeff_len )
+{
+    int32_t result = 0;
+    int64_t intermediate_mul;
+    uint8_t coeff_idx;
+    
+    for ( coeff_idx = coeff_len;
+          coeff_idx > 0;
+          coeff_idx-- )
+    {
+        intermediate_mul = ((int64_t) result) * ((int64_t) var_in);
+        result           = (int32_t) (intermediate_mul >> calc_qnum) + coeff[ coeff_idx - 1 ];
+    }
+    
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the servo correction input for a sweep index.
+///
+/// The servo position command (LSB = 0.001rad) is swept over the full int16
+/// range and scaled to Q30 as performed by the servo module.
+///
+/// @note   The servo module's Q30 input scaling is valid for position
+///         commands within +/-1.024rad; commands outside of the range are
+///         wrapped to it (11-bit signed), as by the servo module (see
+///         ServoPosCorrect).
+////////////////////////////////////////////////////////////////////////////////
+static int32_t BenchServoVarGet( uint32_t sweep_idx )
+{
+    int16_t cmd_pos;
+    int32_t var_in;
+
+    cmd_pos = (int16_t) ( (int32_t) sweep_idx + INT16_MIN );
+
+    // Note: Implementation defined behavior.  Shift operators retain the sign.
+    cmd_pos = (int16_t) ( (uint16_t) cmd_pos << ( 16U - 11U ) ) >> ( 16U - 11U );
+
+    var_in = (int32_t) cmd_pos << 21;
+    var_in = var_in / 1000;
+    var_in = var_in << 9;
+
+    return var_in;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the VSENSE correction input for a sweep index.
+///
+/// The 12-bit ADC value is swept over its full range and scaled to Q30 as
+/// performed by the VSENSE module.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t BenchVsenseVarGet( uint32_t sweep_idx )
+{
+    return (int32_t) sweep_idx << ( 30U - 12U );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Benchmark all evaluators for a calibration case.
+///
+/// @param  bench_case
+///             The calibration case.
+/// @param  result
+///             Buffer for storing the result of each evaluator.
+////////////////////////////////////////////////////////////////////////////////
+static void BenchCaseRun( const BENCH_CASE_S* bench_case,
+                          BENCH_RESULT_S result[ BENCH_EVAL_NUM_OF ] )
+{
+    // Evaluators in order of BENCH_EVAL_E.
+    //
+    // Note: The specialized evaluator is defined by the calibration case.
+    //
+    static const BENCH_EVAL_F bench_eval[ BENCH_EVAL_NUM_OF ] =
+    {
+        BenchPoly32Pow, // BENCH_EVAL_POW
+        UtilPoly32,     // BENCH_EVAL_POLY32
+        BenchPoly32C,   // BENCH_EVAL_POLY32_C
+        NULL,           // BENCH_EVAL_POLY32_SPEC
+    };
+
+    const int32_t* coeff;
+    uint32_t cyc_sum[ BENCH_EVAL_NUM_OF ] = { 0 };
+
+    uint32_t sweep_idx;
+    uint8_t  eval_idx;
+
+    int32_t  var_in;
+    int32_t  ref_out = 0;
+    int32_t  eval_out;
+    uint32_t eval_err;
+
+    uint16_t start_cyc;
+    uint16_t elapsed_cyc;
+
+    coeff = bench_case->coeff_get();
+
+    for( eval_idx = 0;
+         eval_idx < BENCH_EVAL_NUM_OF;
+         eval_idx++ )
+    {
+        result[ eval_idx ].cyc_max = 0;
+        result[ eval_idx ].err_max = 0;
+    }
+
+    for( sweep_idx = 0;
+         sweep_idx < bench_case->sweep_len;
+         sweep_idx++ )
+    {
+        var_in = bench_case->var_get( sweep_idx );
+
+        for( eval_idx = 0;
+             eval_idx < BENCH_EVAL_NUM_OF;
+             eval_idx++ )
+        {
+            // Measure the evaluator execution time.
+            //
+            // Note: The measurement includes the function call overhead and
+            // one read of the cycle counter (several instruction cycles).
+            //
+            if( eval_idx == BENCH_EVAL_POLY32_SPEC )
+            {
+                start_cyc   = TMRCycleGet();
+                eval_out    = bench_case->spec_eval( var_in, coeff );
+                elapsed_cyc = TMRCycleGet() - start_cyc;
+            }
+            else
+            {
+                start_cyc   = TMRCycleGet();
+                eval_out    = bench_eval[ eval_idx ]( var_in,
+                                                      bench_case->calc_qnum,
+                                                      coeff,
+                                                      bench_case->coeff_len );
+                elapsed_cyc = TMRCycleGet() - start_cyc;
+            }
+
+            cyc_sum[ eval_idx ] += elapsed_cyc;
+
+            if( elapsed_cyc > result[ eval_idx ].cyc_max )
+            {
+                result[ eval_idx ].cyc_max = elapsed_cyc;
+            }
+
+            // Compare the output to that of the reference evaluator.
+            if( eval_idx == 0 )
+            {
+                ref_out = eval_out;
+            }
+
+            eval_err = ( eval_out >= ref_out ) ?
+                            (uint32_t) eval_out - (uint32_t) ref_out :
+                            (uint32_t) ref_out  - (uint32_t) eval_out;
+
+            if( eval_err > UINT16_MAX )
+            {
+                eval_err = UINT16_MAX;
+            }
+
+            if( eval_err > result[ eval_idx ].err_max )
+            {
+                result[ eval_idx ].err_max = (uint16_t) eval_err;
+            }
+        }
+
+        // Clear the watchdog timer - the benchmark exceeds the watchdog
+        // timeout.
+        WDTService();
+    }
+
+    for( eval_idx = 0;
+         eval_idx < BENCH_EVAL_NUM_OF;
+         eval_idx++ )
+    {
+        result[ eval_idx ].cyc_mean = (uint16_t) ( cyc_sum[ eval_idx ] / bench_case->sweep_len );
+    }
+}
+
+#endif
\ No newline at end of file
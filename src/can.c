@@ -13,11 +13,108 @@
 
 #include "can.h"
 #include "cfg.h"
+#include "tmr.h"
+#include "wdt.h"
 
 // *****************************************************************************
 // ************************** Defines ******************************************
 // *****************************************************************************
 
+/// Number of entries of the receive queues (power of 2, at most 128).
+///
+/// @note   The configuration request queues hold a burst of requests from a
+///         configuration tool (e.g. reading of all configuration values).
+#define CAN_RX_SERVO_RING_LEN   4U
+#define CAN_RX_CFG_RING_LEN     32U
+
+/// Receive FIFO area (buffers 11-15) used by the configuration requests.
+#define CAN_RX_FIFO_START       11U
+#define CAN_RX_FIFO_LEN         5U
+#define CAN_RX_FIFO_MASK        0xF800U
+
+/// Acceptance filter of the Configuration Write request (see CANInit).
+#define CAN_RX_FILTER_CFG_WRITE 3U
+
+/// Number of transmit buffers (TRB0-TRB7).
+#define CAN_TX_BUF_NUM_OF       8U
+
+/// Identifies that no transmit buffer is selected.
+#define CAN_TX_BUF_NONE         0xFFU
+
+/// Number of entries of each transmit queue (power of 2, at most 128).
+#define CAN_TX_QUEUE_LEN        8U
+
+/// Time waited for a valid message at each bit rate of the auto-baud probe
+/// (LSB = 1 instruction cycle).
+///
+/// @note   Exceeds twice the Servo Command period (10ms), so that a message
+///         is received at the correct bit rate on a bus with an active FMU.
+#define CAN_AUTOBAUD_WAIT_CYC   ( 25000UL * TMR_CYC_PER_US )
+
+/// Data length (DLC) field of the hardware message header (word 2).
+#define CAN_TX_HEADER_DLC_MASK  0x000FU
+
+/// Hardware elements of a transmit buffer.
+typedef struct
+{
+    volatile uint16_t* trcon_p; ///< Control register.
+    uint8_t ctrl_shift;         ///< Position of the buffer's control byte within the register.
+   
+} CAN_TX_BUF_MAP_S;
+
+/// Transmitted message queue entry.
+typedef struct
+{
+    uint8_t  tx_msg_type;       ///< Type of message (CAN_TX_MSG_TYPE_E).
+    uint16_t payload[ 4 ];      ///< Message payload.
+    
+} CAN_TX_ENTRY_S;
+
+/// Transmitted message queue of a priority (single-producer/single-consumer
+/// ring).
+///
+/// @note   Multi-threaded data written by the software cycle (producer) and
+///         read by the CAN interrupt (consumer).  The producer only writes 
+///         the entries, 'head', 'drop_cnt' and 'hwm', and the consumer only
+///         writes 'tail' and 'buf_idx'.  See CAN_RX_RING_S for the indices.
+typedef struct
+{
+    CAN_TX_ENTRY_S entry[ CAN_TX_QUEUE_LEN ];   ///< Queue entries.
+    volatile uint8_t head;      ///< Number of entries written (roll-over counter).
+    volatile uint8_t tail;      ///< Number of entries read (roll-over counter).
+    uint8_t  buf_idx;           ///< Transmit buffer of the last read entry (or CAN_TX_BUF_NONE).
+    uint8_t  hwm;               ///< Maximum number of queued entries.
+    uint16_t drop_cnt;          ///< Number of discarded messages (saturated at maximum value).
+    
+} CAN_TX_QUEUE_S;
+
+/// Received message queue entry.
+typedef struct
+{
+    uint32_t rx_tick;       ///< Reception time (LSB = 1 instruction cycle, see TMRTickGet).
+    uint16_t payload[ 4 ];  ///< Message payload.
+    
+} CAN_RX_ENTRY_S;
+
+/// Received message queue (single-producer/single-consumer ring).
+///
+/// @note   Multi-threaded data written by the CAN receive interrupt 
+///         (producer) and read by the thread processing the message type
+///         (consumer).  The producer only writes the entries and 'head',
+///         and the consumer only writes 'tail' and 'rx_tick'.  The 8-bit
+///         indices are free-running counters - their difference is the
+///         number of queued entries.
+typedef struct
+{
+    CAN_RX_ENTRY_S* entry;      ///< Queue entries.
+    uint8_t idx_mask;           ///< Number of entries minus 1.
+    volatile uint8_t head;      ///< Number of entries written (roll-over counter).
+    volatile uint8_t tail;      ///< Number of entries read (roll-over counter).
+    uint16_t ovf_cnt;           ///< Number of lost messages (saturated at maximum value).
+    uint32_t rx_tick;           ///< Reception time of the entry last read.
+    
+} CAN_RX_RING_S;
+
 // *****************************************************************************
 // ************************** Definitions **************************************
 // *****************************************************************************
@@ -25,11 +122,82 @@
 /// Message buffer for storing RX/TX CAN messages.
 static uint16_t __align( 16 * 16 ) can_msg_buf[ 16 ][ 8 ];
 
+/// Baud rate prescaler (BRP) of each bit rate - see CANInit.
+static const uint8_t can_brp[ CFG_BITRATE_NUM_OF ] =
+{
+    0,      // CFG_BITRATE_1M
+    1,      // CFG_BITRATE_500K
+    3,      // CFG_BITRATE_250K
+    7,      // CFG_BITRATE_125K
+};
+
+/// Applied bit rate.
+static CFG_BITRATE_E can_bitrate = CFG_BITRATE_1M;
+
+/// Mapping of transmit buffers to hardware elements.
+static const CAN_TX_BUF_MAP_S can_tx_buf_map[ CAN_TX_BUF_NUM_OF ] = 
+{
+    { &C1TR01CON, 0 },   // TRB0
+    { &C1TR01CON, 8 },   // TRB1
+    { &C1TR23CON, 0 },   // TRB2
+    { &C1TR23CON, 8 },   // TRB3
+    { &C1TR45CON, 0 },   // TRB4
+    { &C1TR45CON, 8 },   // TRB5
+    { &C1TR67CON, 0 },   // TRB6
+    { &C1TR67CON, 8 },   // TRB7
+};
+
+/// Mapping of message types to transmit priority.
+static const CAN_TX_PRIO_E can_tx_prio[ CAN_TX_MSG_NUM_OF ] =
+{
+    CAN_TX_PRIO_HIGH,   // CAN_TX_MSG_SERVO_STATUS
+    CAN_TX_PRIO_HIGH,   // CAN_TX_MSG_VSENSE_DATA
+    CAN_TX_PRIO_MID,    // CAN_TX_MSG_NODE_STATUS
+    CAN_TX_PRIO_MID,    // CAN_TX_MSG_NODE_VER
+    CAN_TX_PRIO_LOW,    // CAN_TX_MSG_CFG_WRITE_RESP
+    CAN_TX_PRIO_LOW,    // CAN_TX_MSG_CFG_READ_RESP
+    CAN_TX_PRIO_LOW,    // CAN_TX_MSG_DIAG_DATA
+    CAN_TX_PRIO_HIGH,   // CAN_TX_MSG_SERVO_POS
+};
+
+/// Transmitted message queues (one for each priority).
+static CAN_TX_QUEUE_S can_tx_queue[ CAN_TX_PRIO_NUM_OF ];
+
+/// Hardware message header (buffer words 0-2) of each message type.
+///
+/// @note   Headers are constant following initialization, with the exception
+///         of the data length of the Configuration Read Response, which is
+///         set for each message (see CANTxReadRespLenGet).
+static uint16_t can_tx_header[ CAN_TX_MSG_NUM_OF ][ 3 ];
+
+/// Received message queue entries.
+static CAN_RX_ENTRY_S can_rx_servo_entry[ CAN_RX_SERVO_RING_LEN ];
+static CAN_RX_ENTRY_S can_rx_write_entry[ CAN_RX_CFG_RING_LEN ];
+static CAN_RX_ENTRY_S can_rx_read_entry[ CAN_RX_CFG_RING_LEN ];
+
+/// Received message queues (one for each message type).
+static CAN_RX_RING_S can_rx_ring[ CAN_RX_MSG_NUM_OF ] =
+{
+    { can_rx_servo_entry, CAN_RX_SERVO_RING_LEN - 1U, 0, 0, 0, 0 },   // CAN_RX_MSG_SERVO_CMD
+    { can_rx_write_entry, CAN_RX_CFG_RING_LEN   - 1U, 0, 0, 0, 0 },   // CAN_RX_MSG_CFG_WRITE_REQ
+    { can_rx_read_entry,  CAN_RX_CFG_RING_LEN   - 1U, 0, 0, 0, 0 },   // CAN_RX_MSG_CFG_READ_REQ
+};
+
+/// Number of FIFO almost full events (saturated at maximum value).
+static uint16_t can_rx_fifo_full_cnt = 0;
+
+/// Number of messages lost because the FIFO was full (saturated at maximum
+/// value).
+static uint16_t can_rx_fifo_ovf_cnt = 0;
+
 // *****************************************************************************
 // ************************** Function Prototypes ******************************
 // *****************************************************************************
 
-static void CANTxBuildHeader ( CAN_TX_MSG_TYPE_E tx_msg_type, uint16_t msg_buf[ 8 ] );
+static CFG_BITRATE_E CANAutoBaud ( CFG_BITRATE_E bitrate_cfg );
+static void CANRxQueue ( CAN_RX_MSG_TYPE_E rx_msg_type, uint8_t buf_idx, uint32_t rx_tick );
+static void CANTxBuildHeader ( CAN_TX_MSG_TYPE_E tx_msg_type, uint8_t node_id, uint16_t tx_header[ 3 ] );
+static uint8_t CANTxReadRespLenGet ( uint16_t cfg_sel );
 
 // *****************************************************************************
 // ************************** Global Functions *********************************
@@ -37,12 +205,26 @@ static void CANTxBuildHeader ( CAN_TX_MSG_TYPE_E tx_msg_type, uint16_t msg_buf[
 
 void CANInit ( void )
 {
+    CAN_TX_PRIO_E     prio;
+    CAN_TX_MSG_TYPE_E tx_msg_type;
+    CFG_BITRATE_E     bitrate;
+    
     uint8_t node_id;
     
     // Get the node ID - used for filtering received messages for those which
-    // are only applicable to the node.
+    // are only applicable to the node, and as the source of transmitted
+    // messages.
     node_id = CfgNodeIdGet();
     
+    // Build the hardware header of each transmitted message.  The Node ID is
+    // constant until reset, so the headers are only built once.
+    for( tx_msg_type = (CAN_TX_MSG_TYPE_E) 0;
+         tx_msg_type < CAN_TX_MSG_NUM_OF;
+         tx_msg_type++ )
+    {
+        CANTxBuildHeader( tx_msg_type, node_id, &can_tx_header[ tx_msg_type ][ 0 ] );
+    }
+    
     // Configure I/O for CAN peripheral operation.
     //
     ANSELAbits.ANSA4  = 0;          // Configure pin RP20 as digital.
@@ -68,24 +250,30 @@ void CANInit ( void )
     C1CTRL2bits.DNCNT   = 0;        // Disable DeviceNet feature since CAN Specification 2.0A protocol is not used.
     
     C1FCTRLbits.DMABS   = 0b100;    // 16 buffers in RAM.
-    C1FCTRLbits.FSA     = 0;        // N/A, FIFO not used.
+    C1FCTRLbits.FSA     = CAN_RX_FIFO_START;    // FIFO area starts at buffer 11 (buffers 11-15).
     
     C1INTEbits.IVRIE    = 0;        // Invalid Message Interrupt is disabled.
     C1INTEbits.WAKIE    = 0;        // Bus Wake-up Activity Interrupt is disabled.
     C1INTEbits.ERRIE    = 0;        // Error Interrupt is disabled.
-    C1INTEbits.FIFOIE   = 0;        // FIFO Almost Full Interrupt is disabled.
-    C1INTEbits.RBOVIE   = 0;        // RX Buffer Overflow Interrupt is disabled.
-    C1INTEbits.RBIE     = 0;        // RX Buffer Interrupt is disabled.
-    C1INTEbits.TBIE     = 0;        // TX Buffer Interrupt is disabled.
+    C1INTEbits.FIFOIE   = 1;        // FIFO Almost Full Interrupt is enabled - see below.
+    C1INTEbits.RBOVIE   = 1;        // RX Buffer Overflow Interrupt is enabled - see below.
+    C1INTEbits.RBIE     = 1;        // RX Buffer Interrupt is enabled - see below.
+    C1INTEbits.TBIE     = 1;        // TX Buffer Interrupt is enabled - see below.
+    
+    // Get the configured bit rate - used for selection of the time quantum.
+    bitrate = CfgCANBitrateGet();
     
     // Fp    = 20MHz
-    // Fbaud = 1Mbps
+    // Fbaud = 1Mbps, 500kbps, 250kbps, or 125kbps (configured)
     //
-    // Ftq := Time Quantum Frequency (selected as 10MHz - i.e. 10 TQ per bit)
+    // Ftq := Time Quantum Frequency (selected as 10 * Fbaud - i.e. 10 TQ per
+    //        bit, so that the bit segments are identical for all bit rates)
     //
     // BPR = ( Fp    / ( 2 * Ftq   ) ) - 1
-    //     = ( 20MHz / ( 2 * 10MHz ) ) - 1
-    //     = 0
+    //     = ( 20MHz / ( 2 * 10MHz ) ) - 1  = 0     (1Mbps)
+    //     = ( 20MHz / ( 2 *  5MHz ) ) - 1  = 1     (500kbps)
+    //     = ( 20MHz / ( 2 * 2.5MHz) ) - 1  = 3     (250kbps)
+    //     = ( 20MHz / ( 2 * 1.25MHz)) - 1  = 7     (125kbps)
     //
     // Synch Segment     = 1 TQ (constant)
     // Propagation Delay = 3 TQ
@@ -93,8 +281,8 @@ void CANInit ( void )
     // Phase Segment 2   = 3 TQ
     // SJW               = Min( 4, Prop, PS1, PS2 ) = 3 TQ
     //
-    C1CFG1bits.SJW      = 2;    // Select SJW (2 = 3 TQ).
-    C1CFG1bits.BRP      = 0;    // Select baud rate for expected Ftq.
+    C1CFG1bits.SJW      = 2;                    // Select SJW (2 = 3 TQ).
+    C1CFG1bits.BRP      = can_brp[ bitrate ];   // Select baud rate for expected Ftq.
     
     C1CFG2bits.WAKFIL   = 0;    // N/A, b/c sleep mode not used.
     C1CFG2bits.SEG2PH   = 2;    // Select phase segment 2 time (2 = 3 TQ).
@@ -103,25 +291,20 @@ void CANInit ( void )
     C1CFG2bits.SEG1PH   = 2;    // Select phase segment 1 time (2 = 3 TQ).
     C1CFG2bits.PRSEG    = 2;    // Select propagation time (2 = 3 TQ).
     
-    // Setup pointers for transmit buffers and priority levels.
+    // Setup pointers for transmit buffers.
+    //
+    // Note: Messages are moved from the transmit queues to any free buffer,
+    // and the buffer priority level is selected for the message's priority
+    // (see CANTxService).
     //
     C1TR01CONbits.TXEN0     = 1;    // Buffer TRB0 is a transmit buffer.
-    C1TR01CONbits.TX0PRI    = 0b11; // Buffer TRB0 is highest priority.
-    
     C1TR01CONbits.TXEN1     = 1;    // Buffer TRB1 is a transmit buffer.
-    C1TR01CONbits.TX1PRI    = 0b11; // Buffer TRB1 is highest priority.
-    
     C1TR23CONbits.TXEN2     = 1;    // Buffer TRB2 is a transmit buffer.
-    C1TR23CONbits.TX2PRI    = 0b01; // Buffer TRB2 is low intermediate priority.
-    
     C1TR23CONbits.TXEN3     = 1;    // Buffer TRB3 is a transmit buffer.
-    C1TR23CONbits.TX3PRI    = 0b01; // Buffer TRB3 is low intermediate priority.
-    
     C1TR45CONbits.TXEN4     = 1;    // Buffer TRB4 is a transmit buffer.
-    C1TR45CONbits.TX4PRI    = 0b00; // Buffer TRB4 is lowest priority.  
-    
     C1TR45CONbits.TXEN5     = 1;    // Buffer TRB5 is a transmit buffer.
-    C1TR45CONbits.TX5PRI    = 0b00; // Buffer TRB5 is lowest priority. 
+    C1TR67CONbits.TXEN6     = 1;    // Buffer TRB6 is a transmit buffer.
+    C1TR67CONbits.TXEN7     = 1;    // Buffer TRB7 is a transmit buffer.
     
     // -------------------------------------------------------------------------
     //
@@ -134,9 +317,11 @@ void CANInit ( void )
     //      Filter 3 - Configuration Write  (800)
     //      Filter 4 - Configuration Read   (801)
     //
-    // The Configuration Write and Read commands operate at a low-enough of a
-    // rate (and are not flight-critical) so a single receive buffer is used
-    // for processing of the messages.
+    // The Configuration Write and Read commands are not flight-critical, but
+    // are received in bursts from a configuration tool (e.g. reading of all
+    // configuration values).  Both filters store messages in the FIFO area
+    // (buffers 11-15), which is read in order of reception; the accepting 
+    // filter (FILHIT) identifies the message type.
     //
     // The Servo Command message is received at a rate which matches to
     // software cycle rate.  Three message buffers are used to handle
@@ -188,8 +373,8 @@ void CANInit ( void )
     C1BUFPNT1bits.F0BP  = 8;    // Acceptance Filter 0 to use Message Buffer  8 to store message.
     C1BUFPNT1bits.F1BP  = 9;    // Acceptance Filter 1 to use Message Buffer  9 to store message.
     C1BUFPNT1bits.F2BP  = 10;   // Acceptance Filter 2 to use Message Buffer 10 to store message.
-    C1BUFPNT1bits.F3BP  = 11;   // Acceptance Filter 3 to use Message Buffer 11 to store message.   
-    C1BUFPNT2bits.F4BP  = 12;   // Acceptance Filter 4 to use Message Buffer 12 to store message.
+    C1BUFPNT1bits.F3BP  = 0xF;  // Acceptance Filter 3 to use the FIFO to store message.   
+    C1BUFPNT2bits.F4BP  = 0xF;  // Acceptance Filter 4 to use the FIFO to store message.
      
     C1RXF0SIDbits.SID   = 0x015;    // Set filter 0 match values.
     C1RXF0SIDbits.EXIDE = 1;        // Match messages only with extended ID.
@@ -257,152 +442,428 @@ void CANInit ( void )
     
     C1CTRL1bits.WIN = 0; // Select the buffer window for visibility in SFRs.
     
+    // Auto-baud is enabled ?
+    if( CfgCANAutoBaudGet() == true )
+    {
+        // Select the bit rate of the bus traffic (or the configured bit rate
+        // if no traffic is received).
+        bitrate = CANAutoBaud( bitrate );
+    }
+    
+    can_bitrate = bitrate;
+    
     // Request Normal Operating Mode
     C1CTRL1bits.REQOP = 0;
     
     // Wait for the ECAN module to enter into Normal Operating Mode
     while(C1CTRL1bits.OPMODE != 0);
+    
+    // Identify that no message of each priority is being transmitted.
+    for( prio = (CAN_TX_PRIO_E) 0;
+         prio < CAN_TX_PRIO_NUM_OF;
+         prio++ )
+    {
+        can_tx_queue[ prio ].buf_idx = CAN_TX_BUF_NONE;
+    }
+    
+    // Enable the CAN1 interrupt for received and transmitted messages.  The
+    // interrupt drives the processing of Servo Command messages on reception,
+    // rather than polling of the receive buffers by the software cycle.  The
+    // interrupt also moves queued messages to the transmit buffers when a
+    // transmission completes (or a message is queued).
+    //
+    // Note: Interrupt priority is '3' so that the interrupt will preempt all
+    // other threads.  The Configuration Write and Read messages also trigger
+    // the interrupt, which moves them from the FIFO to the receive queues;
+    // they are processed by the software cycle.
+    //
+    C1INTFbits.RBIF     = 0;    // Clear the RX Buffer Interrupt flag.
+    C1INTFbits.FIFOIF   = 0;    // Clear the FIFO Almost Full Interrupt flag.
+    C1INTFbits.RBOVIF   = 0;    // Clear the RX Buffer Overflow Interrupt flag.
+    C1INTFbits.TBIF     = 0;    // Clear the TX Buffer Interrupt flag.
+    IPC8bits.C1IP       = 3;    // Select CAN1 interrupt priority level.
+    IFS2bits.C1IF       = 0;    // Clear CAN1 interrupt flag.
+    IEC2bits.C1IE       = 1;    // Enable CAN1 interrupt.
+}
+
+uint8_t CANBitrateGet ( void )
+{
+    return (uint8_t) can_bitrate;
 }
 
 void CANTxSet ( CAN_TX_MSG_TYPE_E tx_msg_type, const uint16_t payload[ 4 ] )
 {
-    // Structure definition of HW elements corresponding the a message type.
-    typedef struct
+    uint16_t* tx_payload;
+    uint8_t   payload_idx;
+    
+    tx_payload = CANTxAcquire( tx_msg_type );
+    
+    // Transmit queue is not full ?
+    if( tx_payload != NULL )
     {
-        uint8_t buffer_index;
-        volatile uint16_t* trcon_p;
-        uint16_t txreq_mask;
-       
-    } TX_HW_MAP_S;
+        // Copy the payload into the queue entry.
+        for( payload_idx = 0;
+             payload_idx < 4;
+             payload_idx++ )
+        {
+            tx_payload[ payload_idx ] = payload[ payload_idx ];
+        }
+        
+        CANTxCommit( tx_msg_type );
+    }
+}
+
+uint16_t* CANTxAcquire ( CAN_TX_MSG_TYPE_E tx_msg_type )
+{
+    CAN_TX_QUEUE_S* tx_queue = &can_tx_queue[ can_tx_prio[ tx_msg_type ] ];
+    
+    uint16_t* tx_payload = NULL;
+    uint8_t   entry_idx;
+    
+    // Transmit queue is not full ?
+    if( (uint8_t) ( tx_queue->head - tx_queue->tail ) < CAN_TX_QUEUE_LEN )
+    {
+        // Reserve the next entry - the entry is not read by the consumer
+        // until it is committed.
+        entry_idx = tx_queue->head & ( CAN_TX_QUEUE_LEN - 1U );
+        
+        tx_queue->entry[ entry_idx ].tx_msg_type = tx_msg_type;
+        tx_payload = &tx_queue->entry[ entry_idx ].payload[ 0 ];
+    }
+    else
+    {
+        // Identify the discarded message.
+        if( tx_queue->drop_cnt < UINT16_MAX )
+        {
+            tx_queue->drop_cnt++;
+        }
+    }
+    
+    return tx_payload;
+}
+
+void CANTxCommit ( CAN_TX_MSG_TYPE_E tx_msg_type )
+{
+    CAN_TX_QUEUE_S* tx_queue = &can_tx_queue[ can_tx_prio[ tx_msg_type ] ];
+    
+    uint8_t entry_cnt;
+    
+    // Publish the entry to the consumer (CAN interrupt).
+    //
+    // Note: The entry is written before it is published - the compiler is
+    // prevented from reordering memory accesses across the barrier.
+    //
+    __asm__ volatile ( "" ::: "memory" );
+    tx_queue->head++;
+    
+    entry_cnt = tx_queue->head - tx_queue->tail;
+    if( entry_cnt > tx_queue->hwm )
+    {
+        tx_queue->hwm = entry_cnt;
+    }
+    
+    // Request the CAN interrupt so that the message is moved to a transmit
+    // buffer without waiting for completion of a transmission.
+    IFS2bits.C1IF = 1;
+}
+
+bool CANTxFreeGet ( CAN_TX_MSG_TYPE_E tx_msg_type )
+{
+    CAN_TX_QUEUE_S* tx_queue = &can_tx_queue[ can_tx_prio[ tx_msg_type ] ];
     
-    // Mapping of message types to hardware elements for transmitting the message.
-    static const TX_HW_MAP_S tx_hw_map[ CAN_TX_MSG_NUM_OF ] = 
+    // Transmit queue is not full ?
+    return ( (uint8_t) ( tx_queue->head - tx_queue->tail ) < CAN_TX_QUEUE_LEN );
+}
+
+uint8_t CANTxFreeCntGet ( CAN_TX_MSG_TYPE_E tx_msg_type )
+{
+    CAN_TX_QUEUE_S* tx_queue = &can_tx_queue[ can_tx_prio[ tx_msg_type ] ];
+    
+    return CAN_TX_QUEUE_LEN - (uint8_t) ( tx_queue->head - tx_queue->tail );
+}
+
+void CANTxService ( void )
+{
+    // Transmit buffer priority level (TXnPRI) of each priority.
+    static const uint8_t tx_buf_pri[ CAN_TX_PRIO_NUM_OF ] =
     {
-        { 0, &C1TR01CON, 0x0008 },   // CAN_TX_MSG_SERVO_STATUS
-        { 1, &C1TR01CON, 0x0800 },   // CAN_TX_MSG_VSENSE_DATA
-        { 2, &C1TR23CON, 0x0008 },   // CAN_TX_MSG_NODE_STATUS
-        { 3, &C1TR23CON, 0x0800 },   // CAN_TX_MSG_NODE_VER
-        { 4, &C1TR45CON, 0x0008 },   // CAN_TX_MSG_CFG_WRITE_RESP
-        { 5, &C1TR45CON, 0x0800 },   // CAN_TX_MSG_CFG_READ_RESP
+        0b11,   // CAN_TX_PRIO_HIGH
+        0b01,   // CAN_TX_PRIO_MID
+        0b00,   // CAN_TX_PRIO_LOW
     };
     
-    uint8_t buf_idx;
-    uint8_t payload_idx;
+    CAN_TX_QUEUE_S* tx_queue;
     
-    // Transmission request is not already set - i.e. a transmission is not
-    // already in progress for the transmit buffer ?
-    if( ( *tx_hw_map[ tx_msg_type ].trcon_p & tx_hw_map[ tx_msg_type ].txreq_mask ) == 0 )
-    {   
-        // Copy buffer index to local variable for processing efficiency
-        // and reduced line length.
-        buf_idx = tx_hw_map[ tx_msg_type ].buffer_index;
+    CAN_TX_PRIO_E prio;
+    
+    volatile uint16_t* trcon_p;
+    uint8_t  ctrl_shift;
+    uint8_t  buf_idx;
+    uint8_t  entry_idx;
+    uint8_t  payload_idx;
+    uint8_t  tx_msg_type;
+    
+    // Release the transmit buffer of each priority whose transmission is
+    // complete.
+    //
+    // Note: A single message of each priority is transmitted at a time, so
+    // that messages of a priority are transmitted in order of queuing (i.e.
+    // the hardware does not select between buffers of equal priority level).
+    //
+    // Note: All buffers are released before any is assigned.  Otherwise a
+    // higher priority could be assigned the completed buffer of a lower
+    // priority, which would then find the buffer requested again and hold
+    // its queue until the higher priority stops using the buffer.
+    //
+    for( prio = (CAN_TX_PRIO_E) 0;
+         prio < CAN_TX_PRIO_NUM_OF;
+         prio++ )
+    {
+        tx_queue = &can_tx_queue[ prio ];
         
-        // Copy the payload to the transmit buffer.
-        for( payload_idx = 0;
-             payload_idx < 4;
-             payload_idx++ )
+        if( tx_queue->buf_idx != CAN_TX_BUF_NONE )
         {
-            // Note: First 3 words of hardware buffer are used for CAN ID,
-            // DLC, and control bits.
-            can_msg_buf[ buf_idx ][ payload_idx + 3 ] = payload[ payload_idx ];
+            trcon_p    = can_tx_buf_map[ tx_queue->buf_idx ].trcon_p;
+            ctrl_shift = can_tx_buf_map[ tx_queue->buf_idx ].ctrl_shift;
+            
+            if( ( *trcon_p & ( 0x0008 << ctrl_shift ) ) == 0 )
+            {
+                tx_queue->buf_idx = CAN_TX_BUF_NONE;
+            }
+        }
+    }
+    
+    // Move a queued message of each priority without a message in
+    // transmission to a free transmit buffer, in order of decreasing
+    // priority.
+    for( prio = (CAN_TX_PRIO_E) 0;
+         prio < CAN_TX_PRIO_NUM_OF;
+         prio++ )
+    {
+        tx_queue = &can_tx_queue[ prio ];
+        
+        // Transmit queue is not empty ?
+        if( ( tx_queue->buf_idx == CAN_TX_BUF_NONE ) &&
+            ( tx_queue->head    != tx_queue->tail  ) )
+        {
+            // Find a free transmit buffer (i.e. transmission request is not
+            // set).
+            for( buf_idx = 0;
+                 buf_idx < CAN_TX_BUF_NUM_OF;
+                 buf_idx++ )
+            {
+                trcon_p    = can_tx_buf_map[ buf_idx ].trcon_p;
+                ctrl_shift = can_tx_buf_map[ buf_idx ].ctrl_shift;
+                
+                if( ( *trcon_p & ( 0x0008 << ctrl_shift ) ) == 0 )
+                {
+                    break;
+                }
+            }
+            
+            // Transmit buffer is free ?
+            if( buf_idx < CAN_TX_BUF_NUM_OF )
+            {
+                entry_idx   = tx_queue->tail & ( CAN_TX_QUEUE_LEN - 1U );
+                tx_msg_type = tx_queue->entry[ entry_idx ].tx_msg_type;
+                
+                // Copy the payload to the transmit buffer.
+                for( payload_idx = 0;
+                     payload_idx < 4;
+                     payload_idx++ )
+                {
+                    // Note: First 3 words of hardware buffer are used for CAN
+                    // ID, DLC, and control bits.
+                    can_msg_buf[ buf_idx ][ payload_idx + 3 ] = tx_queue->entry[ entry_idx ].payload[ payload_idx ];
+                }
+                
+                // Copy the CAN message header.
+                can_msg_buf[ buf_idx ][ 0 ] = can_tx_header[ tx_msg_type ][ 0 ];
+                can_msg_buf[ buf_idx ][ 1 ] = can_tx_header[ tx_msg_type ][ 1 ];
+                can_msg_buf[ buf_idx ][ 2 ] = can_tx_header[ tx_msg_type ][ 2 ];
+                
+                // Configuration Read Response has a variable length ?
+                if( tx_msg_type == CAN_TX_MSG_CFG_READ_RESP )
+                {
+                    can_msg_buf[ buf_idx ][ 2 ] = ( can_msg_buf[ buf_idx ][ 2 ] & ~CAN_TX_HEADER_DLC_MASK ) |
+                                                  CANTxReadRespLenGet( can_msg_buf[ buf_idx ][ 3 ] );
+                }
+                
+                // Release the entry to the producer (software cycle).
+                //
+                // Note: See the memory barrier of CANRxGet.
+                //
+                __asm__ volatile ( "" ::: "memory" );
+                tx_queue->tail++;
+                tx_queue->buf_idx = buf_idx;
+                
+                // Select the priority level and request (i.e. set request bit
+                // to '1') the transmission - the control byte is written with
+                // the buffer enabled for transmission (TXEN), the request
+                // (TXREQ) and the priority level (TXPRI).
+                //
+                // Note: 
+                //      Since non-atomic read-modify-write operation performed,
+                //      a extremely small possibly exists for duplicate 
+                //      transmission of a message.
+                //
+                //      For example, if bit 'TXREQ0' is being updated, and
+                //      following the read operation (of the read-modify-write)
+                //      the hardware clears bit 'TXREQ1', then the software 
+                //      would unintentionally set the 'TXREQ1' bit during the
+                //      write operation - causing re-transmission of the TX1 
+                //      message.
+                //
+                //      The software could be designed to use the hardware
+                //      register bit-field definitions for accessing the 
+                //      register, which would result in the compiler assembling
+                //      the access to an atomic operation (i.e. BSET), but this
+                //      yields a less scalable and more complex design.
+                //
+                *trcon_p = ( *trcon_p & ~( 0x00FF << ctrl_shift ) ) |
+                           ( ( 0x0088 | tx_buf_pri[ prio ] ) << ctrl_shift );
+            }
         }
+    }
+}
 
-        // Build the CAN message header.
-        CANTxBuildHeader( tx_msg_type, &can_msg_buf[ buf_idx ][ 0 ] );
+void CANTxQueueCntGet ( CAN_TX_PRIO_E prio, uint16_t* drop_cnt, uint8_t* hwm )
+{
+    *drop_cnt = can_tx_queue[ prio ].drop_cnt;
+    *hwm      = can_tx_queue[ prio ].hwm;
+}
+
+bool CANRxGet ( CAN_RX_MSG_TYPE_E rx_msg_type, uint16_t payload[ 4 ] )
+{
+    CAN_RX_RING_S* rx_ring = &can_rx_ring[ rx_msg_type ];
+    
+    uint8_t payload_idx;
+    uint8_t entry_idx;
+    
+    bool data_rx_flag = false;
+    
+    // Receive queue is not empty ?
+    if( rx_ring->head != rx_ring->tail )
+    {
+        // Identify data as received.
+        data_rx_flag = true;
         
-        // Request (i.e. set request bit to '1') the transmission.
-        //
-        // Note: 
-        //      Since non-atomic read-modify-write operation performed, a
-        //      extremely small possibly exists for duplicate transmission of a
-        //      message.
-        //
-        //      For example, if bit 'TXREQ0' is being updated, and following the
-        //      read operation (of the read-modify-write) the hardware clears 
-        //      bit 'TXREQ1', then the software would unintentionally set the
-        //      'TXREQ1' bit during the write operation - causing 
-        //      re-transmission of the TX1 message.
+        // Copy the oldest entry's payload into supplied buffer.
+        entry_idx = rx_ring->tail & rx_ring->idx_mask;
+        
+        for ( payload_idx = 0;
+              payload_idx < 4;
+              payload_idx++ )
+        {
+            payload[ payload_idx ] = rx_ring->entry[ entry_idx ].payload[ payload_idx ];
+        }
+        
+        rx_ring->rx_tick = rx_ring->entry[ entry_idx ].rx_tick;
+        
+        // Release the entry to the producer (CAN receive interrupt).
         //
-        //      The software could be designed to use the hardware register
-        //      bit-field definitions for accessing the register, which would
-        //      result in the compiler assembling the access to an atomic 
-        //      operation (i.e. BSET), but this yields a less scalable and more 
-        //      complex design.
+        // Note: The entry is read before it is released - the compiler is
+        // prevented from reordering memory accesses across the barrier.
         //
-        *tx_hw_map[ tx_msg_type ].trcon_p |= tx_hw_map[ tx_msg_type ].txreq_mask;
+        __asm__ volatile ( "" ::: "memory" );
+        rx_ring->tail++;
     }
+ 
+    return data_rx_flag;
 }
 
-bool CANRxGet ( CAN_RX_MSG_TYPE_E rx_msg_type, uint16_t payload[ 4 ] )
+uint32_t CANRxTickGet ( CAN_RX_MSG_TYPE_E rx_msg_type )
+{
+    return can_rx_ring[ rx_msg_type ].rx_tick;
+}
+
+uint16_t CANRxOvfCntGet ( CAN_RX_MSG_TYPE_E rx_msg_type )
+{
+    return can_rx_ring[ rx_msg_type ].ovf_cnt;
+}
+
+void CANRxService ( void )
 {
-    // Structure definition of HW elements corresponding to a message type.
+    // Structure definition of HW elements corresponding to a receive buffer.
     typedef struct
     {
         uint8_t buffer_index;
-        volatile uint16_t* rxful_p;
         uint16_t rxful_mask;
        
     } RX_HW_MAP_S;
     
-    static const RX_HW_MAP_S hw_map_servo_cmd[] = 
+    // Servo Command receive buffers, in order of increasing buffer index.
+    //
+    // Note: The hardware stores a message at the lowest-indexed free buffer
+    // of the filters accepting the message.  Messages received while no 
+    // buffer is being read therefore occupy the buffers in order of 
+    // reception, and are read in that order.  A message received after its
+    // buffer is read (i.e. freed), but before a higher-indexed buffer is 
+    // read, is stored at the freed buffer and read by the next interrupt - 
+    // a message received later at a higher-indexed buffer is then read 
+    // before it.  This requires two messages to be received while the 
+    // buffers are read.  The reading takes less than the minimum CAN frame
+    // time (47us at 1Mbit/s) and is not preempted (the CAN1 interrupt has
+    // the highest priority); therefore, the order of reception is preserved
+    // in practice, but is not guaranteed by the hardware.
+    //
+    static const RX_HW_MAP_S rx_hw_map[] = 
     {
-        {  8, &C1RXFUL1, 0x0100 },
-        {  9, &C1RXFUL1, 0x0200 },
-        { 10, &C1RXFUL1, 0x0400 },
-        {  0, NULL,      0x0000 },   // NULL terminated
+        {  8, 0x0100 },
+        {  9, 0x0200 },
+        { 10, 0x0400 },
     };
     
-    static const RX_HW_MAP_S hw_map_cfg_write[] = 
-    {
-        { 11, &C1RXFUL1, 0x0800 },
-        {  0, NULL,      0x0000 },   // NULL terminated
-    };
+    CAN_RX_RING_S* rx_ring = &can_rx_ring[ CAN_RX_MSG_SERVO_CMD ];
     
-    static const RX_HW_MAP_S hw_map_cfg_read[] = 
-    {
-        { 12, &C1RXFUL1, 0x1000 },
-        {  0, NULL,      0x0000 },   // NULL terminated
-    };
-    
-    static const RX_HW_MAP_S* const rx_hw_map[ CAN_RX_MSG_NUM_OF ] =
-    {
-        &hw_map_servo_cmd[ 0 ],     // CAN_RX_MSG_SERVO_CMD
-        &hw_map_cfg_write[ 0 ],     // CAN_RX_MSG_CFG_WRITE_REQ
-        &hw_map_cfg_read[ 0 ],      // CAN_RX_MSG_CFG_READ_REQ
-    };
+    uint32_t rx_tick;
+    uint16_t ovf_mask;
+    uint8_t  map_idx;
+    uint8_t  fifo_idx;
+    uint8_t  buf_idx;
+    uint8_t  filhit;
+    bool     fifo_full;
     
+    // Clear the RX Buffer, FIFO Almost Full, RX Buffer Overflow, and TX 
+    // Buffer Interrupt flags, then the CAN1 interrupt flag.
+    //
+    // Note: The CAN1 interrupt flag is set by the ECAN interrupt flags;
+    // therefore, the ECAN interrupt flags are cleared first.  The TX Buffer
+    // Interrupt flag is cleared here since it also sets the CAN1 interrupt
+    // flag; the transmit buffers are serviced by CANTxService.
+    //
+    fifo_full = C1INTFbits.FIFOIF;
+    C1INTFbits.RBIF   = 0;
+    C1INTFbits.FIFOIF = 0;
+    C1INTFbits.RBOVIF = 0;
+    C1INTFbits.TBIF   = 0;
+    IFS2bits.C1IF     = 0;
     
-    uint8_t payload_idx;
-    uint8_t map_idx;
+    // FIFO is almost full (i.e. a single free buffer remains) ?
+    //
+    // Note: The FIFO is emptied below; the event is counted to identify 
+    // configuration request bursts approaching the FIFO length.
+    //
+    if( fifo_full == true )
+    {
+        if( can_rx_fifo_full_cnt < UINT16_MAX )
+        {
+            can_rx_fifo_full_cnt++;
+        }
+    }
     
-    bool    data_rx_flag = false;
-    uint8_t buf_idx;
+    // Note: The reception time of all messages read by the interrupt is 
+    // that of the interrupt's execution.
+    rx_tick = TMRTickGet();
     
-    // Iterate through the receive buffers to get the freshest data.
     for( map_idx = 0;
-         rx_hw_map[ rx_msg_type ][ map_idx ].rxful_p != NULL;
+         map_idx < sizeof( rx_hw_map ) / sizeof( rx_hw_map[ 0 ] );
          map_idx++ )
     {
         // Buffer is full ?
-        if( ( *rx_hw_map[ rx_msg_type ][ map_idx ].rxful_p & 
-                    rx_hw_map[ rx_msg_type ][ map_idx ].rxful_mask ) != 0 )
+        if( ( C1RXFUL1 & rx_hw_map[ map_idx ].rxful_mask ) != 0 )
         {
-            // Identify data as received.
-            data_rx_flag  = true;
-            
-            // Copy buffer index to local variable for processing efficiency
-            // and reduced line length.
-            buf_idx = rx_hw_map[ rx_msg_type ][ map_idx ].buffer_index;
-
-            // Copy payload into supplied buffer.
-            for ( payload_idx = 0;
-                  payload_idx < 4;
-                  payload_idx++ )
-            {
-                // Note: First 3 words of hardware buffer are used for CAN ID,
-                // DLC, and control bits.
-                payload[ payload_idx ] = can_msg_buf[ buf_idx ][ payload_idx + 3 ];
-            }
+            CANRxQueue( CAN_RX_MSG_SERVO_CMD, rx_hw_map[ map_idx ].buffer_index, rx_tick );
             
             // Clear the receiver buffer flag so the hardware will receive a
             // new message into the buffer.
@@ -412,27 +873,293 @@ bool CANRxGet ( CAN_RX_MSG_TYPE_E rx_msg_type, uint16_t payload[ 4 ] )
             // of RXFUL register bits will yield deterministic behavior since
             // masked bits are written with a value of '1'.
             //
-            *rx_hw_map[ rx_msg_type ][ map_idx ].rxful_p &= ~rx_hw_map[ rx_msg_type ][ map_idx ].rxful_mask;
+            C1RXFUL1 &= ~rx_hw_map[ map_idx ].rxful_mask;
+        }
+        
+        // A message was received while the buffer was full (i.e. the message
+        // was lost) ?
+        if( ( C1RXOVF1 & rx_hw_map[ map_idx ].rxful_mask ) != 0 )
+        {
+            if( rx_ring->ovf_cnt < UINT16_MAX )
+            {
+                rx_ring->ovf_cnt++;
+            }
+            
+            // Note: See clearing of RXFUL register bits.
+            C1RXOVF1 &= ~rx_hw_map[ map_idx ].rxful_mask;
         }
     }
- 
-    return data_rx_flag;
+    
+    // Read the FIFO from the next buffer to be read, until an empty buffer
+    // is reached.
+    //
+    // Note: The number of buffers read is limited to the FIFO length, which
+    // bounds the interrupt execution time when messages are received while
+    // the FIFO is read.  Remaining messages are read by the interrupt of 
+    // their reception.
+    //
+    for( fifo_idx = 0;
+         fifo_idx < CAN_RX_FIFO_LEN;
+         fifo_idx++ )
+    {
+        buf_idx = C1FIFObits.FNRB;
+        
+        // Buffer is empty ?
+        if( ( C1RXFUL1 & ( 1U << buf_idx ) ) == 0 )
+        {
+            break;
+        }
+        
+        // Identify the message type by the filter which accepted the message
+        // (word 7, bits 12-8).
+        filhit = ( can_msg_buf[ buf_idx ][ 7 ] >> 8 ) & 0x1F;
+        
+        if( filhit == CAN_RX_FILTER_CFG_WRITE )
+        {
+            CANRxQueue( CAN_RX_MSG_CFG_WRITE_REQ, buf_idx, rx_tick );
+        }
+        else
+        {
+            CANRxQueue( CAN_RX_MSG_CFG_READ_REQ, buf_idx, rx_tick );
+        }
+        
+        // Clear the receiver buffer flag - the hardware advances the next
+        // buffer to be read (FNRB).
+        //
+        // Note: See clearing of RXFUL register bits above.
+        //
+        C1RXFUL1 &= ~( 1U << buf_idx );
+    }
+    
+    // A message was received while the FIFO was full (i.e. the message was
+    // lost) ?
+    //
+    // Note: The type of a lost message is unknown; FIFO losses are counted
+    // separately from those of the message types.
+    //
+    ovf_mask = C1RXOVF1 & CAN_RX_FIFO_MASK;
+    
+    if( ovf_mask != 0 )
+    {
+        for( buf_idx = CAN_RX_FIFO_START;
+             buf_idx < CAN_RX_FIFO_START + CAN_RX_FIFO_LEN;
+             buf_idx++ )
+        {
+            if( ( ( ovf_mask & ( 1U << buf_idx ) ) != 0 ) &&
+                ( can_rx_fifo_ovf_cnt < UINT16_MAX ) )
+            {
+                can_rx_fifo_ovf_cnt++;
+            }
+        }
+        
+        // Note: See clearing of RXFUL register bits above.
+        C1RXOVF1 &= ~ovf_mask;
+    }
+}
+
+void CANRxFifoCntGet ( uint16_t* full_cnt, uint16_t* ovf_cnt )
+{
+    *full_cnt = can_rx_fifo_full_cnt;
+    *ovf_cnt  = can_rx_fifo_ovf_cnt;
+}
+
+void CANIntEnable ( void )
+{
+    IEC2bits.C1IE = 1;
+}
+
+void CANIntDisable ( void )
+{
+    IEC2bits.C1IE = 0;
 }
 
 // *****************************************************************************
 // ************************** Static Functions *********************************
 // *****************************************************************************
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Select the CAN bit rate from the bus traffic (auto-baud).
+///
+/// Each bit rate is applied in Listen Only Mode (i.e. the node does not
+/// acknowledge messages or transmit error frames, so the bus is not 
+/// disturbed), starting with the configured bit rate.  The first bit rate at
+/// which a valid message is received is selected.  If no valid message is
+/// received at any bit rate, the configured bit rate is selected.
+///
+/// @param  bitrate_cfg
+///             The configured bit rate.
+///
+/// @return The selected bit rate.
+///
+/// @note   Function is executed by CANInit in Configuration Mode, following
+///         configuration of the receive buffers; the module is returned to
+///         Configuration Mode with the selected bit rate applied and the
+///         receive buffers empty.
+///
+/// @note   All messages are accepted during the probe (filter 5 with mask 1,
+///         which matches any identifier), so that any bus traffic is 
+///         detected.
+////////////////////////////////////////////////////////////////////////////////
+static CFG_BITRATE_E CANAutoBaud ( CFG_BITRATE_E bitrate_cfg )
+{
+    CFG_BITRATE_E bitrate = bitrate_cfg;
+    
+    uint32_t start_tick;
+    uint8_t  probe_idx = 0;
+    bool     rx_valid  = false;
+    
+    // Accept all messages into buffer 8.
+    C1CTRL1bits.WIN      = 1;       // Select the filters for visibility in SFRs.
+    
+    C1BUFPNT2bits.F5BP   = 8;       // Acceptance Filter 5 to use Message Buffer 8 to store message.
+    C1FMSKSEL1bits.F5MSK = 0b01;    // Set filter 5 for mask 1 match.
+    C1RXM1SID            = 0;       // Set mask 1 - ignore all bits, match standard and extended IDs.
+    C1RXM1EID            = 0;       // Set mask 1 - ignore all bits.
+    C1FEN1bits.FLTEN5    = 1;       // Enable filter 5.
+    
+    C1CTRL1bits.WIN      = 0;       // Select the buffer window for visibility in SFRs.
+    
+    while( ( rx_valid  == false              ) &&
+           ( probe_idx <  CFG_BITRATE_NUM_OF ) )
+    {
+        // Select the bit rate - the configured bit rate, then each following
+        // bit rate in turn.
+        bitrate = (CFG_BITRATE_E) ( ( bitrate_cfg + probe_idx ) % CFG_BITRATE_NUM_OF );
+        
+        // Request Configuration Mode to update the bit rate.
+        C1CTRL1bits.REQOP = 4;
+        while(C1CTRL1bits.OPMODE != 4);
+        
+        C1CFG1bits.BRP  = can_brp[ bitrate ];
+        C1INTFbits.RBIF = 0;
+        
+        // Request Listen Only Mode.
+        C1CTRL1bits.REQOP = 3;
+        while(C1CTRL1bits.OPMODE != 3);
+        
+        // Wait for a valid message.
+        //
+        // Note: Messages with errors (e.g. received at an incorrect bit rate)
+        // are not stored, and therefore do not set the RX Buffer Interrupt
+        // flag.
+        //
+        start_tick = TMRTickGet();
+        
+        while( ( C1INTFbits.RBIF == 0 ) &&
+               ( TMRTickGet() - start_tick < CAN_AUTOBAUD_WAIT_CYC ) )
+        {
+            // Clear the watchdog timer - the probe of all bit rates exceeds
+            // the watchdog timeout.
+            WDTService();
+        }
+        
+        rx_valid = ( C1INTFbits.RBIF != 0 );
+        
+        probe_idx++;
+    }
+    
+    // No valid message was received ?
+    if( rx_valid == false )
+    {
+        bitrate = bitrate_cfg;
+    }
+    
+    // Return to Configuration Mode and apply the selected bit rate.
+    C1CTRL1bits.REQOP = 4;
+    while(C1CTRL1bits.OPMODE != 4);
+    
+    C1CFG1bits.BRP = can_brp[ bitrate ];
+    
+    // Restore the acceptance filters.
+    C1CTRL1bits.WIN   = 1;          // Select the filters for visibility in SFRs.
+    C1FEN1bits.FLTEN5 = 0;          // Disable filter 5.
+    C1CTRL1bits.WIN   = 0;          // Select the buffer window for visibility in SFRs.
+    
+    // Discard the messages received by the probe.
+    //
+    // Note: Software can only clear RXFUL and RXOVF register bits.
+    //
+    C1RXFUL1        = 0;
+    C1RXOVF1        = 0;
+    C1INTFbits.RBIF = 0;
+    
+    return bitrate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Queue a received message.
+///
+/// The payload of the receive buffer is copied into a new entry of the 
+/// message type's receive queue.  If the queue is full, the message is 
+/// discarded and counted as lost.
+///
+/// @param  rx_msg_type
+///             Type of message received.
+/// @param  buf_idx
+///             Index of the receive buffer storing the message.
+/// @param  rx_tick
+///             Reception time of the message (see TMRTickGet).
+///
+/// @note   Function is executed by the CAN receive interrupt only (i.e. the
+///         single producer of the queues).
+////////////////////////////////////////////////////////////////////////////////
+static void CANRxQueue ( CAN_RX_MSG_TYPE_E rx_msg_type, uint8_t buf_idx, uint32_t rx_tick )
+{
+    CAN_RX_RING_S* rx_ring = &can_rx_ring[ rx_msg_type ];
+    
+    uint8_t payload_idx;
+    uint8_t entry_idx;
+    
+    // Receive queue is not full ?
+    if( (uint8_t) ( rx_ring->head - rx_ring->tail ) <= rx_ring->idx_mask )
+    {
+        entry_idx = rx_ring->head & rx_ring->idx_mask;
+        
+        // Copy payload into the queue entry.
+        for ( payload_idx = 0;
+              payload_idx < 4;
+              payload_idx++ )
+        {
+            // Note: First 3 words of hardware buffer are used for CAN ID,
+            // DLC, and control bits.
+            rx_ring->entry[ entry_idx ].payload[ payload_idx ] = can_msg_buf[ buf_idx ][ payload_idx + 3 ];
+        }
+        
+        rx_ring->entry[ entry_idx ].rx_tick = rx_tick;
+        
+        // Publish the entry to the consumer.
+        //
+        // Note: The entry is written before it is published - the compiler
+        // is prevented from reordering memory accesses across the barrier.
+        //
+        __asm__ volatile ( "" ::: "memory" );
+        rx_ring->head++;
+    }
+    else
+    {
+        // Identify the discarded message.
+        if( rx_ring->ovf_cnt < UINT16_MAX )
+        {
+            rx_ring->ovf_cnt++;
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief  Build header data for supplied message type.
 ///
 /// @param  tx_msg_type
 ///             The type of message.
-/// @param  msg_buf
-///             Buffer which contains message payload and is used for storing
-///             message header.                   
+/// @param  node_id
+///             The Node ID (i.e. source of the message).
+/// @param  tx_header
+///             Buffer for storing the hardware message header (buffer words
+///             0-2).
+///
+/// @note   The data length of the Configuration Read Response is set to 0 -
+///         see CANTxReadRespLenGet.
 ////////////////////////////////////////////////////////////////////////////////
-static void CANTxBuildHeader ( CAN_TX_MSG_TYPE_E tx_msg_type, uint16_t msg_buf[ 8 ] )
+static void CANTxBuildHeader ( CAN_TX_MSG_TYPE_E tx_msg_type, uint8_t node_id, uint16_t tx_header[ 3 ] )
 {
     // Union defining the contents of the CAN ID field.
     typedef union
@@ -567,7 +1294,7 @@ static void CANTxBuildHeader ( CAN_TX_MSG_TYPE_E tx_msg_type, uint16_t msg_buf[
         
         // CAN_TX_MSG_CFG_READ_RESP
         {
-            0,              // data_len     - Variable, special case treated with execution.
+            0,              // data_len     - Variable, set for each message (see CANTxReadRespLenGet).
             
             {
                 {
@@ -578,6 +1305,34 @@ static void CANTxBuildHeader ( CAN_TX_MSG_TYPE_E tx_msg_type, uint16_t msg_buf[
                 },
             },
         },
+        
+        // CAN_TX_MSG_DIAG_DATA
+        {
+            8,              // data_len
+            
+            {
+                {
+                    0,          // dest_id      - N/A, broadcast message.
+                    0,          // src_id       - N/A, set real-time.        
+                    0b10,       // tsf_type     - Message broadcast.
+                    772,        // data_type    - 772 identifies Node Diagnostics Message.
+                },
+            },
+        },
+        
+        // CAN_TX_MSG_SERVO_POS
+        {
+            4,              // data_len
+            
+            {
+                {
+                    0,          // dest_id      - N/A, broadcast message.
+                    0,          // src_id       - N/A, set real-time.        
+                    0b10,       // tsf_type     - Message broadcast.
+                    22,         // data_type    - 22 identifies Servo Position Message.
+                },
+            },
+        },
     };
     
     
@@ -604,54 +1359,66 @@ static void CANTxBuildHeader ( CAN_TX_MSG_TYPE_E tx_msg_type, uint16_t msg_buf[
         },
     };
     
-    uint8_t node_id;
-    
-    node_id = CfgNodeIdGet();
-    
-    // Copy the CAN ID from NVM and update the Node ID.
+    // Copy the CAN ID and update the Node ID.
     can_id        = tx_can_data[ tx_msg_type ].can_id;
     can_id.src_id = node_id;
     
-    // Populate the hardware header format with the CAN ID.
+    // Populate the hardware header format with the CAN ID and length.
     tx_hw_header.sid    = can_id.id_hi;
     tx_hw_header.eid_hi = can_id.id_md;
     tx_hw_header.eid_lo = can_id.id_lo;
+    tx_hw_header.dlc    = tx_can_data[ tx_msg_type ].data_len;
     
-    // Handle the special case of Configuration Read Response which has a
-    // variable length.
-    if( tx_msg_type == CAN_TX_MSG_CFG_READ_RESP )
+    // Copy the hardware header into the supplied buffer.
+    tx_header[ 0 ] = tx_hw_header.data_u16[ 0 ];
+    tx_header[ 1 ] = tx_hw_header.data_u16[ 1 ];  
+    tx_header[ 2 ] = tx_hw_header.data_u16[ 2 ];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Determine the data length of a Configuration Read Response.
+///
+/// @param  cfg_sel
+///             The configuration selection of the response (i.e. payload
+///             word 0).
+///
+/// @return The data length (in bytes).
+////////////////////////////////////////////////////////////////////////////////
+static uint8_t CANTxReadRespLenGet ( uint16_t cfg_sel )
+{
+    uint8_t data_len;
+    
+    // For the Configuration Read Response message, the first word within
+    // the payload (i.e. buffer word 3) identifies the type of data
+    // returned.  Possible data includes:
+    //
+    //  Payload word 3      Description             Length (in bytes)
+    //  0                   Node ID                 1
+    //  1-6                 PWM coefficients        4 (each)
+    //  7-12                VSENSE1 Coefficients    4 (each)
+    //  13-18               VSENSE2 Coefficients    4 (each)
+    //  19                  PWM calibration type    1
+    //  20                  PWM breakpoint count    1
+    //  21-36               PWM breakpoint position 4 (each)
+    //  37-52               PWM breakpoint PWM      4 (each)
+    //  53                  CAN bit rate            1
+    //  54                  CAN auto-baud enable    1
+    //
+    // The data length (dlc) for each Read Response Message is 2 bytes for
+    // the type identifier (i.e. buffer word 3) plus the value's length.
+    //
+    if( ( cfg_sel == 0  ) ||
+        ( cfg_sel == 19 ) ||
+        ( cfg_sel == 20 ) ||
+        ( cfg_sel == 53 ) ||
+        ( cfg_sel == 54 ) )
     {
-        // For the Configuration Read Response message, the first word within
-        // the payload (i.e. buffer word 3) identifies the type of data
-        // returned.  Possible data includes:
-        //
-        //  Payload word 3      Description             Length (in bytes)
-        //  0                   Node ID                 1
-        //  1-6                 PWM coefficients        4 (each)
-        //  7-12                VSENSE1 Coefficients    4 (each)
-        //  13-18               VSENSE2 Coefficients    4 (each)
-        //
-        // The data length (dlc) for each Read Response Message is 2 bytes for
-        // the type identifier (i.e. buffer word 3) plus the value's length.
-        //
-        if( msg_buf[ 3 ] == 0 )
-        {
-            tx_hw_header.dlc = 2 + 1;
-        }
-        else
-        {
-            tx_hw_header.dlc = 2 + 4;
-        }
+        data_len = 2 + 1;
     }
     else
     {
-        // The message is not a Configuration Read Response.  The length is
-        // computed statically.
-        tx_hw_header.dlc = tx_can_data[ tx_msg_type ].data_len;
+        data_len = 2 + 4;
     }
     
-    // Copy the hardware header into the transmit buffer.
-    msg_buf[ 0 ] = tx_hw_header.data_u16[ 0 ];
-    msg_buf[ 1 ] = tx_hw_header.data_u16[ 1 ];  
-    msg_buf[ 2 ] = tx_hw_header.data_u16[ 2 ];
+    return data_len;
 }
\ No newline at end of file
@@ -20,6 +20,40 @@
 // ************************** Defines ******************************************
 // *****************************************************************************
 
+/// Definition of configuration data values.
+typedef struct
+{
+    uint8_t  node_id;                                   // word  0          (note: padded to word size)
+    int32_t  pwm_coeff[ CFG_PWM_COEFF_LEN ];            // word  1-12
+    int32_t  vsense1_coeff[ CFG_VSENSE1_COEFF_LEN ];    // word 13-24
+    int32_t  vsense2_coeff[ CFG_VSENSE2_COEFF_LEN ];    // word 25-36
+    uint8_t  pwm_cal_type;                              // word 37 (low byte)
+    uint8_t  pwm_pwl_len;                               // word 37 (high byte)
+    int16_t  pwm_pwl_pos[ CFG_PWM_PWL_LEN ];            // word 38-53
+    int32_t  pwm_pwl_pwm[ CFG_PWM_PWL_LEN ];            // word 54-85
+    uint8_t  can_bitrate;                               // word 86 (low byte)
+    uint8_t  can_autobaud;                              // word 86 (high byte)
+    
+} CFG_VAL_S;
+
+#if CFG_PWM_PWL_LEN > UTIL_PWL_LEN_MAX
+#error "CFG_PWM_PWL_LEN exceeds the maximum number of piecewise-linear breakpoints."
+#endif
+
+/// Maximum number of read requests serviced per software cycle.
+///
+/// @note   Limits the software cycle execution time during a burst of read
+///         requests from a configuration tool.
+#define CFG_READ_DRAIN_MAX  8U
+
+/// Maximum number of write requests serviced per software cycle.
+///
+/// @note   The write requests serviced in a software cycle are applied with
+///         one update of the NVM page.  The limit bounds the number of Write
+///         Response messages queued by the software cycle (i.e. the transmit
+///         queue length).
+#define CFG_WRITE_BATCH_MAX 8U
+
 /// Definition of configuration data field.
 /// 
 /// @note   The Program Memory page is 2048 bytes (i.e. 512 program 
@@ -33,12 +67,9 @@ typedef union
 {
     struct
     {
-        uint8_t  node_id;                                   // word  0          (note: padded to word size)
-        int32_t  pwm_coeff[ CFG_PWM_COEFF_LEN ];            // word  1-12
-        int32_t  vsense1_coeff[ CFG_VSENSE1_COEFF_LEN ];    // word 13-24
-        int32_t  vsense2_coeff[ CFG_VSENSE2_COEFF_LEN ];    // word 25-36
-
-        uint16_t reserved[ 475 ];                           // word 37-512
+        CFG_VAL_S val;                                      // word  0-86
+        
+        uint16_t reserved[ 425 ];                           // word 87-511
     }dstruct;
     
     uint16_t data_u16[ 512 ];
@@ -56,76 +87,122 @@ typedef union
 static const CFG_DATA_U __align( 1024 ) cfg_data =
 {
     {
-        0x7F,                       // Initialize node_id to maximum 7-bit value.
-        { 0, 100000, 0, 0, 0, 0 },  // Initialize coefficients to 1st-degree polynomial with 1E3 output scaling.
-        { 0,  10000, 0, 0, 0, 0 },  // Initialize coefficients to 1st-degree polynomial with 1E1 output scaling.
-        { 0,  10000, 0, 0, 0, 0 },  // Initialize coefficients to 1st-degree polynomial with 1E1 output scaling.
-        { 0 },                      // Set reserved storage to '0'.
+        {
+            0x7F,                       // Initialize node_id to maximum 7-bit value.
+            { 0, 100000, 0, 0, 0, 0 },  // Initialize coefficients to 1st-degree polynomial with 1E3 output scaling.
+            { 0,  10000, 0, 0, 0, 0 },  // Initialize coefficients to 1st-degree polynomial with 1E1 output scaling.
+            { 0,  10000, 0, 0, 0, 0 },  // Initialize coefficients to 1st-degree polynomial with 1E1 output scaling.
+            CFG_CAL_POLY,               // Initialize PWM calibration to the polynomial.
+            2,                          // Initialize breakpoints to the polynomial's linear curve over +/-1.024rad.
+            { -1024, 1023 },
+            { -102400, 102300 },
+            CFG_BITRATE_1M,             // Initialize CAN bit rate to 1Mbps.
+            0,                          // Initialize CAN auto-baud to disabled.
+        },
+        { 0 },                          // Set reserved storage to '0'.
     }
 };
 
+/// RAM copy of the configuration data values.
+///
+/// @note   The copy is refreshed from NVM only when the NVM page is 
+///         programmed, so that the configuration data is not read from
+///         Program Memory (i.e. PSV) on each access.
+///
+/// @note   Multi-threaded data written by the software cycle and read by the
+///         CAN receive interrupt (servo coefficients).  The CAN1 interrupt
+///         is disabled while the copy is refreshed.
+static CFG_VAL_S cfg_val;
+
+/// PWM piecewise-linear calibration curve, determined from the RAM copy of
+/// the configuration data values.
+///
+/// @note   Multi-threaded data - see cfg_val.
+static UTIL_PWL_S cfg_pwm_pwl;
+
+/// Applied PWM calibration type.
+static CFG_CAL_E cfg_pwm_cal_type;
+
+/// Generation of the configuration data (see CfgGenGet).
+static uint16_t cfg_gen = 0;
+
 // *****************************************************************************
 // ************************** Function Prototypes ******************************
 // *****************************************************************************
 
 static void CfgWrite( void );
+static bool CfgWriteSel( CFG_VAL_S* val, const CAN_RX_WRITE_REQ_U* write_req );
 static void CfgRead( void );
+static void CfgRefresh( void );
 
 // *****************************************************************************
 // ************************** Global Functions *********************************
 // *****************************************************************************
 
+void CfgInit( void )
+{
+    CfgRefresh();
+}
+
 void CfgService( void )
 {
-    // Service a write request.
+    // Service the write requests.
     CfgWrite();
     
-    // Service a read request.
+    // Service the read requests.
     CfgRead();
 }
 
+uint16_t CfgGenGet( void )
+{
+    return cfg_gen;
+}
+
 uint8_t CfgNodeIdGet( void )
 {
-    return cfg_data.dstruct.node_id;
+    return cfg_val.node_id;
 }
 
-void CfgPWMCoeffGet( int32_t pwm_coeff[ CFG_PWM_COEFF_LEN ] )
+CFG_BITRATE_E CfgCANBitrateGet( void )
 {
-    uint8_t coeff_idx;
+    CFG_BITRATE_E bitrate = CFG_BITRATE_1M;
     
-    // Copy coefficients to supplied buffer.
-    for ( coeff_idx = 0;
-          coeff_idx < CFG_PWM_COEFF_LEN;
-          coeff_idx++ )
+    if( cfg_val.can_bitrate < CFG_BITRATE_NUM_OF )
     {
-        pwm_coeff[ coeff_idx ] = cfg_data.dstruct.pwm_coeff[ coeff_idx ];
+        bitrate = (CFG_BITRATE_E) cfg_val.can_bitrate;
     }
+    
+    return bitrate;
 }
 
-void CfgVsense1CoeffGet( int32_t vsense1_coeff[ CFG_VSENSE1_COEFF_LEN ] )
+bool CfgCANAutoBaudGet( void )
 {
-    uint8_t coeff_idx;
-    
-    // Copy coefficients to supplied buffer.
-    for ( coeff_idx = 0;
-          coeff_idx < CFG_VSENSE1_COEFF_LEN;
-          coeff_idx++ )
-    {
-        vsense1_coeff[ coeff_idx ] = cfg_data.dstruct.vsense1_coeff[ coeff_idx ];
-    }
+    return ( cfg_val.can_autobaud == 1 );
 }
 
-void CfgVsense2CoeffGet( int32_t vsense2_coeff[ CFG_VSENSE2_COEFF_LEN ] )
+const int32_t* CfgPWMCoeffGet( void )
 {
-    uint8_t coeff_idx;
-    
-    // Copy coefficients to supplied buffer.
-    for ( coeff_idx = 0;
-          coeff_idx < CFG_VSENSE2_COEFF_LEN;
-          coeff_idx++ )
-    {
-        vsense2_coeff[ coeff_idx ] = cfg_data.dstruct.vsense2_coeff[ coeff_idx ];
-    }
+    return &cfg_val.pwm_coeff[ 0 ];
+}
+
+const int32_t* CfgVsense1CoeffGet( void )
+{
+    return &cfg_val.vsense1_coeff[ 0 ];
+}
+
+const int32_t* CfgVsense2CoeffGet( void )
+{
+    return &cfg_val.vsense2_coeff[ 0 ];
+}
+
+CFG_CAL_E CfgPWMCalTypeGet( void )
+{
+    return cfg_pwm_cal_type;
+}
+
+const UTIL_PWL_S* CfgPWMPwlGet( void )
+{
+    return &cfg_pwm_pwl;
 }
 
 // *****************************************************************************
@@ -133,70 +210,97 @@ void CfgVsense2CoeffGet( int32_t vsense2_coeff[ CFG_VSENSE2_COEFF_LEN ] )
 // *****************************************************************************
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief  Service a configuration write request.
+/// @brief  Service the configuration write requests.
 ///
-/// If a configuration write request is received, the value is updated
-/// in NVM and a configuration write response message is queued for
-/// transmission.
+/// The queued configuration write requests are applied to a RAM copy of the
+/// configuration data, the NVM page is updated once with the copy, and a
+/// configuration write response message is queued for transmission for each
+/// request.
+///
+/// @note   Up to CFG_WRITE_BATCH_MAX requests are serviced per software 
+///         cycle, limited to the number of responses which can be queued.
+///         Further requests remain queued for the following software 
+///         cycles.  Each software cycle which services requests requires 
+///         one erase and programming of the NVM page, regardless of the
+///         number of requests serviced.
 ////////////////////////////////////////////////////////////////////////////////
 static void CfgWrite( void )
 {
     static CFG_DATA_U cfg_data_cpy;
     
+    // Configuration selections of the serviced requests.
+    static uint16_t write_sel[ CFG_WRITE_BATCH_MAX ];
+    
     CAN_RX_WRITE_REQ_U  write_req_payload;
     CAN_TX_WRITE_RESP_U write_resp_payload;
             
     bool node_id_update = false;
     
-    bool payload_valid;
+    uint8_t write_cnt = 0;
+    uint8_t write_max;
+    uint8_t write_idx;
+    
+    bool payload_valid = false;
     bool fault_status;
     
-    payload_valid = CANRxGet( CAN_RX_MSG_CFG_WRITE_REQ, write_req_payload.data_u16 );
+    // Limit the number of requests serviced to the number of responses which
+    // can be queued.
+    //
+    // Note: Entries of the transmit queue are only freed by the CAN 
+    // interrupt; therefore, the number of free entries is not reduced until
+    // the responses are queued below.
+    //
+    write_max = CANTxFreeCntGet( CAN_TX_MSG_CFG_WRITE_RESP );
+    if( write_max > CFG_WRITE_BATCH_MAX )
+    {
+        write_max = CFG_WRITE_BATCH_MAX;
+    }
+    
+    if( write_max > 0 )
+    {
+        payload_valid = CANRxGet( CAN_RX_MSG_CFG_WRITE_REQ, write_req_payload.data_u16 );
+    }
     
     // Write request message received ?
     if( payload_valid == true )
     {
         // Copy the configuration data from NVM to RAM.
         cfg_data_cpy.dstruct = cfg_data.dstruct;
+    }
+    
+    while( payload_valid == true )
+    {
+        // Update the selected field in RAM with the new value.
+        if( CfgWriteSel( &cfg_data_cpy.dstruct.val, &write_req_payload ) == true )
+        {
+            node_id_update = true;
+        }
+        
+        write_sel[ write_cnt ] = write_req_payload.cfg_sel;
+        write_cnt++;
         
-        // Update the selected fields in RAM with the new value.
-        switch( write_req_payload.cfg_sel )
+        // Get the next queued request, if its response can be queued.
+        payload_valid = false;
+        if( write_cnt < write_max )
         {
-            case 0:
-                cfg_data_cpy.dstruct.node_id = write_req_payload.cfg_val_u8;
-                node_id_update =  true;
-                break;
-                
-            case 1:
-            case 2:
-            case 3:
-            case 4:
-            case 5:
-            case 6:
-                cfg_data_cpy.dstruct.pwm_coeff[ write_req_payload.cfg_sel - 1 ] = write_req_payload.cfg_val_i32;
-                break;
-            
-            case 7:
-            case 8:
-            case 9:
-            case 10:
-            case 11:
-            case 12:
-                cfg_data_cpy.dstruct.vsense1_coeff[ write_req_payload.cfg_sel - 7 ] = write_req_payload.cfg_val_i32;
-                break;
-            
-            case 13:
-            case 14:
-            case 15:
-            case 16:
-            case 17:
-            case 18:
-                cfg_data_cpy.dstruct.vsense2_coeff[ write_req_payload.cfg_sel - 13 ] = write_req_payload.cfg_val_i32;
-                break;
-            
-            default:
-                ;
+            payload_valid = CANRxGet( CAN_RX_MSG_CFG_WRITE_REQ, write_req_payload.data_u16 );
         }
+    }
+    
+    // Write request message(s) received ?
+    if( write_cnt > 0 )
+    {
+        // Disable the CAN1 interrupt while the NVM page and its RAM copy are
+        // updated, so that the servo correction coefficients are not read by
+        // Servo Command processing while partially updated.
+        //
+        // Note: The CAN1 interrupt also moves queued messages to the transmit
+        // buffers; therefore, both Servo Command processing and transmission
+        // are suspended for the NVM page update (i.e. ~one software cycle).
+        // Received and queued messages are serviced when the interrupt is 
+        // enabled.
+        //
+        CANIntDisable();
         
         // Erase the NVM page.
         fault_status = NVMErasePage( __builtin_tblpage(   &cfg_data ), 
@@ -211,19 +315,36 @@ static void CfgWrite( void )
                                           __builtin_tbloffset( &cfg_data ) );
         }
         
-        // Construct the Write Response message
-        write_resp_payload.cfg_sel      = write_req_payload.cfg_sel;
-        write_resp_payload.fault_status = fault_status;
+        // Refresh the RAM copy with the NVM page content.
+        //
+        // Note: The RAM copy is refreshed regardless of the operation's
+        // success, so that it is consistent with the NVM page.
+        //
+        CfgRefresh();
         
-        // Send the Write Response message.
-        CANTxSet( CAN_TX_MSG_CFG_WRITE_RESP, write_resp_payload.data_u16 );
+        CANIntEnable();
+        
+        // Send a Write Response message for each request, with the status
+        // of the common NVM page update.
+        for( write_idx = 0;
+             write_idx < write_cnt;
+             write_idx++ )
+        {
+            // Construct the Write Response message
+            write_resp_payload.cfg_sel      = write_sel[ write_idx ];
+            write_resp_payload.fault_status = fault_status;
+            
+            // Send the Write Response message.
+            CANTxSet( CAN_TX_MSG_CFG_WRITE_RESP, write_resp_payload.data_u16 );
+        }
         
         // Node ID was updated ?
         if( node_id_update == true )
         {
-            // Wait for 5ms so the Write Response CAN message has time
-            // to be transmitted.
-            UtilDelay( 5 );
+            // Wait for 10ms so the Write Response CAN messages have time
+            // to be transmitted (i.e. up to CFG_WRITE_BATCH_MAX messages
+            // at the minimum bit rate).
+            UtilDelay( 10 );
             
             // Perform a software reset so that the updated Node ID can
             // be used for CAN message filtering.
@@ -233,23 +354,114 @@ static void CfgWrite( void )
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief  Service a configuration read request.
+/// @brief  Apply a configuration write request to configuration data values.
+///
+/// @param  val
+///             The configuration data values updated.
+/// @param  write_req
+///             The configuration write request.
 ///
-/// If a configuration read request is received, the selected value is 
-/// read from NVM and populated in a configuration read response message which
+/// @return true  - the Node ID was updated.
+///         false - the Node ID was not updated.
+////////////////////////////////////////////////////////////////////////////////
+static bool CfgWriteSel( CFG_VAL_S* val, const CAN_RX_WRITE_REQ_U* write_req )
+{
+    bool node_id_update = false;
+    
+    switch( write_req->cfg_sel )
+    {
+        case 0:
+            val->node_id = write_req->cfg_val_u8;
+            node_id_update = true;
+            break;
+            
+        case 1:
+        case 2:
+        case 3:
+        case 4:
+        case 5:
+        case 6:
+            val->pwm_coeff[ write_req->cfg_sel - 1 ] = write_req->cfg_val_i32;
+            break;
+            
+        case 7:
+        case 8:
+        case 9:
+        case 10:
+        case 11:
+        case 12:
+            val->vsense1_coeff[ write_req->cfg_sel - 7 ] = write_req->cfg_val_i32;
+            break;
+            
+        case 13:
+        case 14:
+        case 15:
+        case 16:
+        case 17:
+        case 18:
+            val->vsense2_coeff[ write_req->cfg_sel - 13 ] = write_req->cfg_val_i32;
+            break;
+            
+        case 19:
+            val->pwm_cal_type = write_req->cfg_val_u8;
+            break;
+            
+        case 20:
+            val->pwm_pwl_len = write_req->cfg_val_u8;
+            break;
+            
+        case 53:
+            val->can_bitrate = write_req->cfg_val_u8;
+            break;
+            
+        case 54:
+            val->can_autobaud = write_req->cfg_val_u8;
+            break;
+            
+        default:
+            // PWM piecewise-linear breakpoint selected (21-36 position,
+            // 37-52 PWM) ?
+            if( ( write_req->cfg_sel >= 21 ) && 
+                ( write_req->cfg_sel <  21 + CFG_PWM_PWL_LEN ) )
+            {
+                val->pwm_pwl_pos[ write_req->cfg_sel - 21 ] = (int16_t) write_req->cfg_val_i32;
+            }
+            else if( ( write_req->cfg_sel >= 37 ) && 
+                     ( write_req->cfg_sel <  37 + CFG_PWM_PWL_LEN ) )
+            {
+                val->pwm_pwl_pwm[ write_req->cfg_sel - 37 ] = write_req->cfg_val_i32;
+            }
+    }
+    
+    return node_id_update;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Service the configuration read requests.
+///
+/// For each configuration read request received, the selected value is 
+/// read from the RAM copy of NVM and populated in a configuration read response message which
 /// is queued for transmission.
+///
+/// @note   Up to CFG_READ_DRAIN_MAX requests are serviced, in order of 
+///         reception.  A request is only read when its response can be
+///         queued; otherwise it remains queued for the next software cycle.
 ////////////////////////////////////////////////////////////////////////////////
 static void CfgRead( void )
 {
     CAN_RX_READ_REQ_U   read_req_payload;      
     CAN_TX_READ_RESP_U  read_resp_payload;
 
-    bool payload_valid;
+    uint8_t read_cnt = 0;
+    bool    payload_valid = false;
     
-    payload_valid = CANRxGet( CAN_RX_MSG_CFG_READ_REQ, read_req_payload.data_u16 );
+    if( CANTxFreeGet( CAN_TX_MSG_CFG_READ_RESP ) == true )
+    {
+        payload_valid = CANRxGet( CAN_RX_MSG_CFG_READ_REQ, read_req_payload.data_u16 );
+    }
     
     // Read request message received ?
-    if( payload_valid == true )
+    while( payload_valid == true )
     {
         // Copy the configuration selection to the response message.
         read_resp_payload.cfg_sel = read_req_payload.cfg_sel;
@@ -259,7 +471,7 @@ static void CfgRead( void )
         switch( read_resp_payload.cfg_sel )
         {
             case 0:
-                read_resp_payload.cfg_val_u8 = cfg_data.dstruct.node_id;
+                read_resp_payload.cfg_val_u8 = cfg_val.node_id;
                 break;
                 
             case 1:
@@ -268,7 +480,7 @@ static void CfgRead( void )
             case 4:
             case 5:
             case 6:
-                read_resp_payload.cfg_val_i32 = cfg_data.dstruct.pwm_coeff[ read_resp_payload.cfg_sel - 1 ];
+                read_resp_payload.cfg_val_i32 = cfg_val.pwm_coeff[ read_resp_payload.cfg_sel - 1 ];
                 break;
             
             case 7:
@@ -277,7 +489,7 @@ static void CfgRead( void )
             case 10:
             case 11:
             case 12:
-                read_resp_payload.cfg_val_i32 = cfg_data.dstruct.vsense1_coeff[ read_resp_payload.cfg_sel - 7 ];
+                read_resp_payload.cfg_val_i32 = cfg_val.vsense1_coeff[ read_resp_payload.cfg_sel - 7 ];
                 break;
             
             case 13:
@@ -286,14 +498,89 @@ static void CfgRead( void )
             case 16:
             case 17:
             case 18:
-                read_resp_payload.cfg_val_i32 = cfg_data.dstruct.vsense2_coeff[ read_resp_payload.cfg_sel - 13 ];
+                read_resp_payload.cfg_val_i32 = cfg_val.vsense2_coeff[ read_resp_payload.cfg_sel - 13 ];
+                break;
+            
+            case 19:
+                read_resp_payload.cfg_val_u8 = cfg_val.pwm_cal_type;
+                break;
+            
+            case 20:
+                read_resp_payload.cfg_val_u8 = cfg_val.pwm_pwl_len;
+                break;
+            
+            case 53:
+                read_resp_payload.cfg_val_u8 = cfg_val.can_bitrate;
+                break;
+            
+            case 54:
+                read_resp_payload.cfg_val_u8 = cfg_val.can_autobaud;
                 break;
             
             default:
-                ;
+                // PWM piecewise-linear breakpoint selected (21-36 position,
+                // 37-52 PWM) ?
+                if( ( read_resp_payload.cfg_sel >= 21 ) && 
+                    ( read_resp_payload.cfg_sel <  21 + CFG_PWM_PWL_LEN ) )
+                {
+                    read_resp_payload.cfg_val_i32 = cfg_val.pwm_pwl_pos[ read_resp_payload.cfg_sel - 21 ];
+                }
+                else if( ( read_resp_payload.cfg_sel >= 37 ) && 
+                         ( read_resp_payload.cfg_sel <  37 + CFG_PWM_PWL_LEN ) )
+                {
+                    read_resp_payload.cfg_val_i32 = cfg_val.pwm_pwl_pwm[ read_resp_payload.cfg_sel - 37 ];
+                }
         }
         
         // Send the Read Response message.
         CANTxSet( CAN_TX_MSG_CFG_READ_RESP, read_resp_payload.data_u16 );
+        
+        // Read the next request, unless the limit is reached.
+        read_cnt++;
+        payload_valid = false;
+        
+        if( ( read_cnt < CFG_READ_DRAIN_MAX ) &&
+            ( CANTxFreeGet( CAN_TX_MSG_CFG_READ_RESP ) == true ) )
+        {
+            payload_valid = CANRxGet( CAN_RX_MSG_CFG_READ_REQ, read_req_payload.data_u16 );
+        }
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Refresh the RAM copy of the configuration data from NVM.
+///
+/// The data derived from the configuration data values (PWM calibration) is
+/// determined, and the configuration data generation is changed to identify
+/// the update.
+////////////////////////////////////////////////////////////////////////////////
+static void CfgRefresh( void )
+{
+    bool pwl_valid;
+    
+    cfg_val = cfg_data.dstruct.val;
+    
+    // Determine the PWM piecewise-linear calibration curve.
+    pwl_valid = UtilPwlInit( &cfg_pwm_pwl,
+                             cfg_val.pwm_pwl_pos,
+                             cfg_val.pwm_pwl_pwm,
+                             cfg_val.pwm_pwl_len );
+    
+    // Piecewise-linear calibration is applied only if selected and valid.
+    if( ( cfg_val.pwm_cal_type == CFG_CAL_PWL ) && 
+        ( pwl_valid            == true        ) )
+    {
+        cfg_pwm_cal_type = CFG_CAL_PWL;
+    }
+    else
+    {
+        cfg_pwm_cal_type = CFG_CAL_POLY;
+    }
+    
+    // Change the generation - 0 is skipped (see CfgGenGet).
+    cfg_gen++;
+    if( cfg_gen == 0 )
+    {
+        cfg_gen = 1;
+    }
+}
\ No newline at end of file
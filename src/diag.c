@@ -0,0 +1,474 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Executive diagnostics.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "diag.h"
+#include "bench.h"
+#include "can.h"
+#include "cfg.h"
+#include "servo.h"
+#include "tmr.h"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+/// Number of software cycles over which the executive load is accumulated
+/// between annunciations of the Executive load record (500ms).
+#define DIAG_LOAD_CYCLES    TMR1_MS_TO_CYCLES( 500U )
+
+/// Execution time statistics of a software service.
+///
+/// @note   Statistics are accumulated between annunciations of the service's
+///         measurement, and are cleared following annunciation.
+typedef struct
+{
+    uint16_t cyc_min;   ///< Minimum execution time (LSB = 1 instruction cycle, saturated).
+    uint16_t cyc_max;   ///< Maximum execution time (LSB = 1 instruction cycle, saturated).
+    uint32_t cyc_sum;   ///< Accumulated execution time (LSB = 1 instruction cycle).
+    uint16_t cnt;       ///< Number of accumulated executions.
+
+} DIAG_PROF_S;
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Execution time statistics of the profiled services.
+static DIAG_PROF_S diag_prof[ DIAG_SVC_NUM_OF ];
+
+/// Cycle counter value of the previous execution time mark (see TMRTickGet).
+static uint32_t diag_mark_cyc;
+
+/// Number of software cycle overruns (saturated at maximum value).
+static uint16_t diag_overrun_cnt;
+
+/// Maximum software cycle execution time since the last annunciation
+/// (LSB = TMR1_PRESCALE instruction cycles).
+static uint32_t diag_cycle_time_max;
+
+/// Background thread iteration counter (16-bit roll-over counter).
+///
+/// @note   Multi-threaded data incremented by the background thread and read
+///         by the software cycle.  A 16-bit counter is used so that the
+///         increment is an atomic operation.  The number of iterations 
+///         performed in one software cycle is below the roll-over value, 
+///         since each iteration requires at least four instruction cycles
+///         (increment, test and taken branch).
+static volatile uint16_t diag_idle_cnt;
+
+/// Background thread execution enabled - cleared to terminate calibration
+/// of the background thread execution rate.
+static volatile bool diag_idle_run = true;
+
+/// Number of background thread iterations performed in one software cycle
+/// when no software cycle processing is performed.
+static uint16_t diag_idle_base;
+
+/// Background thread iteration counter value at the previous software cycle.
+static uint16_t diag_idle_prev;
+
+/// Background thread iterations accumulated since the last annunciation.
+static uint32_t diag_idle_sum;
+
+/// Number of software cycles accumulated since the last annunciation.
+static uint16_t diag_load_cycles;
+
+/// CPU load determined at the last completed accumulation (LSB = 0.1%).
+static uint16_t diag_cpu_load;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+static void DiagProfClear( DIAG_SVC_E svc );
+static void DiagProfAdd( DIAG_SVC_E svc, uint32_t elapsed_cyc );
+static void DiagLoadUpdate( void );
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+void DiagFrameStart ( void )
+{
+    diag_mark_cyc = TMRTickGet();
+}
+
+void DiagMark ( DIAG_SVC_E svc )
+{
+    uint32_t psnt_cyc;
+    uint32_t elapsed_cyc;
+
+    // Determine the time elapsed since the previous mark.
+    //
+    // Note: Unsigned subtraction yields the correct elapsed time through a
+    // roll-over of the cycle counter.
+    //
+    // Note: Execution time of higher priority interrupts which preempt the
+    // service is included in the measurement.
+    //
+    psnt_cyc      = TMRTickGet();
+    elapsed_cyc   = psnt_cyc - diag_mark_cyc;
+    diag_mark_cyc = psnt_cyc;
+
+    DiagProfAdd( svc, elapsed_cyc );
+}
+
+void DiagIsrMark ( DIAG_SVC_E svc, uint32_t start_cyc )
+{
+    // Note: See DiagMark.
+    DiagProfAdd( svc, TMRTickGet() - start_cyc );
+}
+
+void DiagFrameEnd ( void )
+{
+    uint32_t cycle_time;
+    uint16_t idle_cnt;
+
+    // Determine the software cycle execution time - the Timer1 counter is
+    // cleared at the start of each period, so the counter value is the time
+    // elapsed since the start of the software cycle.
+    cycle_time = TMR1Get();
+
+    // The Timer1 period elapsed again before completion of the software
+    // cycle (i.e. the interrupt flag serviced at the start of the cycle is
+    // set) ?
+    if( TMR1FlagGet() == true )
+    {
+        // Identify the software cycle overrun.
+        if( diag_overrun_cnt < UINT16_MAX )
+        {
+            diag_overrun_cnt++;
+        }
+
+        // Include the elapsed period in the execution time.
+        //
+        // Note: Overrun by more than one period is not distinguished.
+        //
+        cycle_time += TMR1_PERIOD_CYC / TMR1_PRESCALE;
+    }
+
+    if( cycle_time > diag_cycle_time_max )
+    {
+        diag_cycle_time_max = cycle_time;
+    }
+
+    // Accumulate the background thread iterations performed since the
+    // previous software cycle.
+    //
+    // Note: Unsigned subtraction yields the correct number of iterations
+    // through a roll-over of the counter.
+    //
+    idle_cnt        = diag_idle_cnt;
+    diag_idle_sum  += (uint16_t) ( idle_cnt - diag_idle_prev );
+    diag_idle_prev  = idle_cnt;
+
+    diag_load_cycles++;
+    if( diag_load_cycles >= DIAG_LOAD_CYCLES )
+    {
+        DiagLoadUpdate();
+    }
+}
+
+void DiagIdleCalibrate ( void )
+{
+    uint16_t idle_start;
+
+    idle_start = diag_idle_cnt;
+
+    // Execute the background thread processing for one software cycle
+    // period - the Timer4 one-shot interrupt terminates the processing (see
+    // DiagIdleStop).
+    //
+    // Note: The calibration executes the loop of the background thread 
+    // itself, rather than a loop which polls a timer, so that the 
+    // calibrated number of iterations is that of the background thread.
+    // The execution time of the one-shot interrupt is negligible.
+    //
+    TMR4OneShotStart();
+    DiagIdle();
+
+    diag_idle_base = diag_idle_cnt - idle_start;
+    diag_idle_prev = diag_idle_cnt;
+    
+    diag_idle_run = true;
+}
+
+void DiagIdleStop ( void )
+{
+    diag_idle_run = false;
+}
+
+void DiagIdle ( void )
+{
+    while( diag_idle_run == true )
+    {
+        diag_idle_cnt++;
+    }
+}
+
+void DiagService ( void )
+{
+    // Diagnostic selection annunciated on the next execution.
+    static uint16_t diag_idx = 0;
+
+    CAN_TX_DIAG_DATA_U diag_msg;
+
+    DIAG_SVC_E  svc;
+    DIAG_PROF_S prof;
+    uint32_t    cyc_mean;
+
+    BENCH_RESULT_S bench_result;
+    uint8_t        bench_idx;
+    
+    CAN_TX_PRIO_E  tx_prio;
+    uint16_t       tx_drop_cnt;
+    uint8_t        tx_hwm;
+
+    // Low priority transmit queue is full (e.g. by a burst of configuration
+    // responses) ?  The diagnostic is annunciated on the next execution,
+    // rather than being dropped by the queue.
+    if( CANTxFreeGet( CAN_TX_MSG_DIAG_DATA ) == true )
+    {
+        // Profiled service selected ?
+        if( diag_idx < DIAG_SVC_NUM_OF )
+        {
+            svc = (DIAG_SVC_E) diag_idx;
+
+            // Read the service's statistics, and restart their accumulation.
+            //
+            // Note: Interrupts are disabled so that the statistics of a
+            // service executed by an interrupt (see DiagIsrMark) are not
+            // updated between the read and the clear.
+            //
+            __builtin_disi( 0x3FFF );
+            prof = diag_prof[ svc ];
+            DiagProfClear( svc );
+            __builtin_disi( 0 );
+
+            // Construct the Diagnostics Data CAN message.
+            diag_msg.diag_sel = diag_idx;
+
+            // Service was executed since the previous annunciation ?
+            if( prof.cnt != 0 )
+            {
+                diag_msg.cyc_min  = prof.cyc_min;
+                diag_msg.cyc_max  = prof.cyc_max;
+                cyc_mean          = prof.cyc_sum / prof.cnt;
+                diag_msg.cyc_mean = ( cyc_mean < UINT16_MAX ) ? (uint16_t) cyc_mean : UINT16_MAX;
+            }
+            else
+            {
+                diag_msg.cyc_min  = 0;
+                diag_msg.cyc_max  = 0;
+                diag_msg.cyc_mean = 0;
+            }
+        }
+        // Record selected ?
+        else if( diag_idx < DIAG_SVC_NUM_OF + DIAG_REC_NUM_OF )
+        {
+            // Construct the Diagnostics Data CAN message.
+            diag_msg.diag_sel = DIAG_REC_SEL_BASE + ( diag_idx - DIAG_SVC_NUM_OF );
+
+            switch( (DIAG_REC_E) ( diag_idx - DIAG_SVC_NUM_OF ) )
+            {
+                case DIAG_REC_LOAD:
+                    // Note: The execution time is scaled to micro-seconds.
+                    diag_msg.overrun_cnt    = diag_overrun_cnt;
+                    diag_msg.cpu_load       = diag_cpu_load;
+                    diag_msg.cycle_time_max = (uint16_t) ( ( diag_cycle_time_max * TMR1_PRESCALE ) / TMR_CYC_PER_US );
+
+                    // Restart accumulation of the maximum execution time.
+                    diag_cycle_time_max = 0;
+                    break;
+                
+                case DIAG_REC_SERVO_MEMO:
+                    // Note: Counters are cumulative (16-bit roll-over), so that
+                    // they are not cleared by the software cycle while updated by
+                    // the CAN receive interrupt.
+                    ServoMemoCntGet( &diag_msg.memo_hit_cnt, &diag_msg.memo_miss_cnt );
+                    diag_msg.cmd_latency_max = ServoLatencyMaxGet();
+                    break;
+                
+                case DIAG_REC_CAN_RX:
+                    // Note: Counters are cumulative (saturated at maximum value)
+                    // for the same reason as those of the servo record.
+                    diag_msg.rx_ovf_cnt[ 0 ] = CANRxOvfCntGet( CAN_RX_MSG_SERVO_CMD );
+                    diag_msg.rx_ovf_cnt[ 1 ] = CANRxOvfCntGet( CAN_RX_MSG_CFG_WRITE_REQ );
+                    diag_msg.rx_ovf_cnt[ 2 ] = CANRxOvfCntGet( CAN_RX_MSG_CFG_READ_REQ );
+                    break;
+                
+                case DIAG_REC_CAN_FIFO:
+                    CANRxFifoCntGet( &diag_msg.fifo_full_cnt, &diag_msg.fifo_ovf_cnt );
+                    diag_msg.data_u16[ 3 ] = 0;     // Unused.
+                    break;
+                
+                case DIAG_REC_CAN_TX_DROP:
+                    for( tx_prio = (CAN_TX_PRIO_E) 0;
+                         tx_prio < CAN_TX_PRIO_NUM_OF;
+                         tx_prio++ )
+                    {
+                        CANTxQueueCntGet( tx_prio, &diag_msg.tx_drop_cnt[ tx_prio ], &tx_hwm );
+                    }
+                    break;
+                
+                case DIAG_REC_CAN_TX_HWM:
+                    for( tx_prio = (CAN_TX_PRIO_E) 0;
+                         tx_prio < CAN_TX_PRIO_NUM_OF;
+                         tx_prio++ )
+                    {
+                        CANTxQueueCntGet( tx_prio, &tx_drop_cnt, &tx_hwm );
+                        diag_msg.tx_hwm[ tx_prio ] = tx_hwm;
+                    }
+                    break;
+
+                case DIAG_REC_CAN_BITRATE:
+                    // Note: The applied bit rate differs from that configured if
+                    // selected by the auto-baud probe.
+                    diag_msg.bitrate_cfg   = CfgCANBitrateGet();
+                    diag_msg.bitrate_act   = CANBitrateGet();
+                    diag_msg.data_u16[ 3 ] = 0;     // Unused.
+                    break;
+
+                default:
+                    ;
+            }
+        }
+        // Benchmark result selected.
+        else
+        {
+            bench_idx = diag_idx - ( DIAG_SVC_NUM_OF + DIAG_REC_NUM_OF );
+        
+            BenchResultGet( bench_idx, &bench_result );
+        
+            // Construct the Diagnostics Data CAN message.
+            diag_msg.diag_sel       = DIAG_BENCH_SEL_BASE + bench_idx;
+            diag_msg.bench_cyc_mean = bench_result.cyc_mean;
+            diag_msg.bench_cyc_max  = bench_result.cyc_max;
+            diag_msg.bench_err_max  = bench_result.err_max;
+        }
+
+        // Send the CAN message.
+        CANTxSet( CAN_TX_MSG_DIAG_DATA, diag_msg.data_u16 );
+
+        // Select the next diagnostic for annunciation - each service's
+        // measurement, each record, and each benchmark result (if the benchmark
+        // is enabled) is annunciated in turn.
+        diag_idx++;
+        if( diag_idx >= DIAG_SVC_NUM_OF + DIAG_REC_NUM_OF + BENCH_RESULT_NUM_OF )
+        {
+            diag_idx = 0;
+        }
+    }
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Clear execution time statistics of a software service.
+///
+/// @param  svc
+///             The service for which statistics are cleared.
+////////////////////////////////////////////////////////////////////////////////
+static void DiagProfClear( DIAG_SVC_E svc )
+{
+    diag_prof[ svc ].cyc_min = 0;
+    diag_prof[ svc ].cyc_max = 0;
+    diag_prof[ svc ].cyc_sum = 0;
+    diag_prof[ svc ].cnt     = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Accumulate an execution time measurement of a software service.
+///
+/// @param  svc
+///             The service which completed execution.
+/// @param  elapsed_cyc
+///             The execution time (LSB = 1 instruction cycle).
+////////////////////////////////////////////////////////////////////////////////
+static void DiagProfAdd( DIAG_SVC_E svc, uint32_t elapsed_cyc )
+{
+    uint16_t elapsed_sat;
+
+    // Saturate the execution time to the 16-bit minimum and maximum (i.e.
+    // ~3.2ms).
+    elapsed_sat = ( elapsed_cyc < UINT16_MAX ) ? (uint16_t) elapsed_cyc : UINT16_MAX;
+
+    // First measurement since statistics were cleared ?
+    if( diag_prof[ svc ].cnt == 0 )
+    {
+        diag_prof[ svc ].cyc_min = elapsed_sat;
+        diag_prof[ svc ].cyc_max = elapsed_sat;
+    }
+    else
+    {
+        if( elapsed_sat < diag_prof[ svc ].cyc_min )
+        {
+            diag_prof[ svc ].cyc_min = elapsed_sat;
+        }
+
+        if( elapsed_sat > diag_prof[ svc ].cyc_max )
+        {
+            diag_prof[ svc ].cyc_max = elapsed_sat;
+        }
+    }
+
+    // Accumulate the measurement for computation of the mean.  Accumulation
+    // is stopped at the counter limit so that the mean remains valid.
+    //
+    // Note: The unsaturated time is accumulated.  Executions of a service do
+    // not overlap, so the sum is at most the time elapsed between
+    // annunciations, and does not overflow.
+    //
+    if( diag_prof[ svc ].cnt < UINT16_MAX )
+    {
+        diag_prof[ svc ].cyc_sum += elapsed_cyc;
+        diag_prof[ svc ].cnt++;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Update the CPU load from the accumulated background thread
+///         iterations.
+///
+/// The CPU load is the fraction of the calibrated background thread
+/// iterations which were not performed because of interrupt processing:
+///
+///     load = 1 - ( idle_sum / ( idle_base * cycles ) )
+///
+////////////////////////////////////////////////////////////////////////////////
+static void DiagLoadUpdate( void )
+{
+    uint32_t idle_max;
+    uint32_t idle_permille;
+
+    idle_max = ( (uint32_t) diag_idle_base ) * diag_load_cycles;
+
+    // Background thread was calibrated ?
+    if( idle_max != 0 )
+    {
+        idle_permille = ( diag_idle_sum * 1000U ) / idle_max;
+
+        // Saturate the load at 0% - see calibration function.
+        if( idle_permille > 1000U )
+        {
+            idle_permille = 1000U;
+        }
+
+        diag_cpu_load = (uint16_t) ( 1000U - idle_permille );
+    }
+
+    diag_idle_sum    = 0;
+    diag_load_cycles = 0;
+}
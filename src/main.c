@@ -17,8 +17,10 @@
 // *****************************************************************************
 
 #include "adc.h"
+#include "bench.h"
 #include "can.h"
 #include "cfg.h"
+#include "diag.h"
 #include "dio.h"
 #include "i2c.h"
 #include "ina219.h"
@@ -26,6 +28,7 @@
 #include "osc.h"
 #include "pwm.h"
 #include "rst.h"
+#include "sch.h"
 #include "servo.h"
 #include "tmr.h"
 #include "ver.h"
@@ -138,6 +141,9 @@ int main ( void )
     // Enable the watchdog timer operation.
     WDTEnable();
     
+    // Initialize the configuration data - used by hardware initialization.
+    CfgInit();
+    
     // Initialize CPU hardware.
     OSCInit();
     TMRInit();
@@ -154,6 +160,29 @@ int main ( void )
     // Determine the processor reset source.
     RSTStartup();
     
+#if BENCH_ENABLE
+    // Perform the calibration math benchmark (development builds only).
+    // The benchmark is performed before interrupts are enabled so that 
+    // execution time measurements are not affected by preemption.
+    BenchRun();
+#endif
+    
+    // Enable the Global Interrupt flag for executive control-flow.
+    INTCON2bits.GIE = 1;
+    
+    // Calibrate the background thread execution rate for determination of
+    // CPU load.  Calibration is performed before the software cycle 
+    // processing is started so that the background thread is not preempted
+    // by the software cycle.
+    //
+    // Note: Global interrupts are enabled, since the calibration period is
+    // terminated by the Timer4 one-shot interrupt.
+    //
+    DiagIdleCalibrate();
+    
+    // Initialize the software cycle task schedule.
+    SchInit();
+    
     // Enable the hardware timer(s) to start interrupt thread(s) of main
     // processing control-flow.
     //
@@ -165,53 +194,109 @@ int main ( void )
     TMR1Enable();
     PWMEnable();
     
-    // Enable the Global Interrupt flag for executive control-flow.
-    INTCON2bits.GIE = 1;
-    
     // Execute background thread infinite-loop.
-    while( 1 );
+    //
+    // Note: Iterations of the background thread are counted to determine the
+    // CPU time not used by the interrupt threads.  The iterations are 
+    // performed within DiagIdle, which does not return following
+    // calibration.
+    //
+    while( 1 )
+    {
+        DiagIdle();
+    }
     
     return 0;
 } 
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief  Main processing thread (10ms period).
+/// @brief  Main processing thread (TMR_FRAME_PERIOD_US period).
 ///
 /// This interrupt serves as the primary processing thread and is triggered
-/// by the Timer1 10ms interrupt.  Interrupt priority is configured as '1', so
-/// that the interrupt will preempt background thread execution.
+/// by the Timer1 software cycle interrupt (10ms by default).  Interrupt 
+/// priority is configured as '1', so that the interrupt will preempt 
+/// background thread execution.
 ////////////////////////////////////////////////////////////////////////////////
 void __interrupt( no_auto_psv ) _T1Interrupt ( void )
 {    
-    // INPUT - Aquire input signals for software cycle execution.
-    ADCService();
-    INA219Service();
-    
-    // PROCESS & OUTPUT - Perform processing and output signals for software
-    // cycle execution.
-    WDTService();
-    VsenseService();
-    ServoService();
-    CfgService();
-    RSTService();
-    VerService();
-    
     // Service the timer 1 interrupt.
+    //
+    // Note: The interrupt flag is serviced at the start of the software
+    // cycle so that a Timer1 period elapsing before completion of the 
+    // software cycle (i.e. an overrun) is identified by the flag being set.
+    //
     TMR1Service();
+    
+    // Start execution time measurement of the software cycle.  Each task
+    // is followed by a mark which attributes its execution time.
+    DiagFrameStart();
+    
+    // Execute the tasks scheduled for the software cycle.
+    SchService();
+    
+    // Complete execution time measurement of the software cycle and detect
+    // overrun.
+    DiagFrameEnd();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Timer roll-over thread (every ~214.7s).
+///
+/// This interrupt is triggered by roll-over of the 32-bit instruction cycle
+/// counter to extend the counter for timestamps.  Interrupt priority is 
+/// configured as '1'.
+////////////////////////////////////////////////////////////////////////////////
+void __interrupt( no_auto_psv ) _T3Interrupt ( void )
+{
+    // Service the timer 2/3 interrupt - count the roll-over.
+    TMR23Service();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Background thread calibration thread (one-shot).
+///
+/// This interrupt is triggered once by the Timer4 one-shot period, to
+/// terminate calibration of the background thread execution rate.  
+/// Interrupt priority is configured as '1'.
+////////////////////////////////////////////////////////////////////////////////
+void __interrupt( no_auto_psv ) _T4Interrupt ( void )
+{
+    // Service the timer 4 interrupt - stop the one-shot period.
+    TMR4Service();
+    
+    // Terminate the calibration.
+    DiagIdleStop();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief  System timer update (0.1ms period)
+/// @brief  CAN receive thread (event-driven).
 ///
-/// This interrupt serves to update the system time and is triggered by the
-/// Timer2 0.1ms interrupt.  Interrupt priority is configured as '2', so that
-/// the interrupt will preempt background thread and T1Interrupt thread
-/// execution.
+/// This interrupt serves to process received Servo Command messages and to
+/// move queued messages to the transmit buffers.  The interrupt is triggered
+/// by the CAN1 receive buffer, receive FIFO, and transmit buffer interrupts,
+/// and is set by software when a message is queued for transmission (see
+/// CANTxCommit).  Interrupt priority is configured as '3', so that the 
+/// interrupt will preempt all other threads and the commanded value is 
+/// applied to the servo on reception.
 ////////////////////////////////////////////////////////////////////////////////
-void __interrupt( no_auto_psv ) _T2Interrupt ( void )
+void __interrupt( no_auto_psv ) _C1Interrupt ( void )
 {
-    // Service the timer 2 interrupt.
-    TMR2Service();
+    uint32_t servo_start_cyc;
+    
+    // Service the CAN1 interrupt - queue the received messages.
+    CANRxService();
+    
+    // Apply the received Servo Commands, and attribute their execution time.
+    servo_start_cyc = TMRTickGet();
+    ServoService();
+    DiagIsrMark( DIAG_SVC_SERVO_ISR, servo_start_cyc );
+    
+    // Move the queued messages to free transmit buffers.
+    //
+    // Note: Performed after the Servo Commands are applied, so that the
+    // command-to-output latency is not increased.
+    //
+    CANTxService();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -126,12 +126,14 @@ void PWMDutySet ( uint16_t pwm_duty )
     //
     // Note: PWM hardware configuration selected for 2.5MHz (0.4us) resolution.
     // Therefore, input parameter (1us LSB) must be scaled by 2.5 for
-    // interfacing with hardware configuration.
+    // interfacing with hardware configuration.  The scaling is performed by 
+    // shift-and-add (2 + 0.5), without an intermediate product which 
+    // overflows for duty cycles above 13.1ms.
     //
     // Note: Immediate vs. period-synchronized updating selected in
     // register bit 'PWMCON3.IUE'.
     //
-    PDC3 = ( pwm_duty * 5U ) / 2U;
+    PDC3 = (uint16_t) ( pwm_duty << 1 ) + ( pwm_duty >> 1 );
 }
 
 // *****************************************************************************
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Software cycle task scheduler.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "sch.h"
+#include "adc.h"
+#include "cfg.h"
+#include "diag.h"
+#include "ina219.h"
+#include "rst.h"
+#include "servo.h"
+#include "tmr.h"
+#include "ver.h"
+#include "vsense.h"
+#include "wdt.h"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+/// Definition of a scheduled task.
+typedef struct
+{
+    void     (*task)( void );   ///< Task function.
+    uint16_t period;            ///< Execution period (LSB = 1 software cycle).
+    uint16_t phase;             ///< Execution offset within the period (LSB = 1 software cycle).
+    DIAG_SVC_E svc;             ///< Execution time profiling identification.
+
+} SCH_TASK_S;
+
+/// Table of scheduled tasks.
+///
+/// Tasks are executed in the order of the table.  A task is executed on the
+/// software cycles where ( cycle count mod period ) equals the phase, with
+/// the first software cycle having a count of zero.
+///
+/// Periods and phases are defined in milliseconds and converted to software
+/// cycles, so that task timing is independent of the software cycle period
+/// (TMR_FRAME_PERIOD_US).  Tasks with a period of one software cycle are
+/// executed at the software cycle rate; all other tasks are grouped at a
+/// 10ms (or slower) rate so that the processing of a fast software cycle
+/// remains within its period.
+///
+/// @note   Servo control is not scheduled - it is executed on reception of
+///         a Servo Command message (see CAN receive interrupt).
+///
+/// @note   Tasks which annunciate CAN messages at the same period are 
+///         assigned different phases so that the messages (and execution
+///         time) are spread evenly across software cycles.  A phase which
+///         is not a multiple of the software cycle period is truncated
+///         (e.g. a 5ms phase is executed with a 0ms phase for a 10ms 
+///         software cycle).
+static const SCH_TASK_S sch_task[] =
+{
+    // INPUT - Aquire input signals for software cycle execution.
+    //
+    // task                 period                          phase                           profiling
+    { ADCService,           TMR1_MS_TO_CYCLES(  10 ),       TMR1_MS_TO_CYCLES(   0 ),       DIAG_SVC_ADC            },
+    { INA219Service,        TMR1_MS_TO_CYCLES(  10 ),       TMR1_MS_TO_CYCLES(   0 ),       DIAG_SVC_INA219         },
+    
+    // PROCESS & OUTPUT - Perform processing and output signals for software
+    // cycle execution.
+    //
+    // task                 period                          phase                           profiling
+    { WDTService,           1,                              0,                              DIAG_SVC_WDT            },
+    { VsenseService,        TMR1_MS_TO_CYCLES(  10 ),       TMR1_MS_TO_CYCLES(   0 ),       DIAG_SVC_VSENSE         },
+    { ServoStatusService,   TMR1_MS_TO_CYCLES(  10 ),       TMR1_MS_TO_CYCLES(   5 ),       DIAG_SVC_SERVO_STATUS   },
+    { CfgService,           TMR1_MS_TO_CYCLES(  10 ),       TMR1_MS_TO_CYCLES(   5 ),       DIAG_SVC_CFG            },
+    { ServoLutService,      TMR1_MS_TO_CYCLES(  10 ),       TMR1_MS_TO_CYCLES(   5 ),       DIAG_SVC_SERVO_LUT      },
+    { RSTService,           TMR1_MS_TO_CYCLES( 500 ),       TMR1_MS_TO_CYCLES(   0 ),       DIAG_SVC_RST            },
+    { VerService,           TMR1_MS_TO_CYCLES( 500 ),       TMR1_MS_TO_CYCLES( 250 ),       DIAG_SVC_VER            },
+    { DiagService,          TMR1_MS_TO_CYCLES(  50 ),       TMR1_MS_TO_CYCLES(  20 ),       DIAG_SVC_DIAG           },
+};
+
+/// Number of scheduled tasks.
+#define SCH_TASK_NUM_OF     ( sizeof( sch_task ) / sizeof( sch_task[ 0 ] ) )
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Number of software cycles remaining until execution of each task.
+static uint16_t sch_timeout[ SCH_TASK_NUM_OF ];
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+void SchInit ( void )
+{
+    uint8_t task_idx;
+    
+    // Initialize each task to be executed at its phase offset.
+    for( task_idx = 0;
+         task_idx < SCH_TASK_NUM_OF;
+         task_idx++ )
+    {
+        sch_timeout[ task_idx ] = sch_task[ task_idx ].phase;
+    }
+}
+
+void SchService ( void )
+{
+    uint8_t task_idx;
+    
+    for( task_idx = 0;
+         task_idx < SCH_TASK_NUM_OF;
+         task_idx++ )
+    {
+        // Task is due for execution ?
+        if( sch_timeout[ task_idx ] == 0 )
+        {
+            // Reload the timeout with the task period.
+            sch_timeout[ task_idx ] = sch_task[ task_idx ].period - 1;
+            
+            // Execute the task and attribute its execution time.
+            sch_task[ task_idx ].task();
+            DiagMark( sch_task[ task_idx ].svc );
+        }
+        else
+        {
+            sch_timeout[ task_idx ]--;
+        }
+    }
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
\ No newline at end of file
@@ -17,6 +17,7 @@
 #include "cfg.h"
 #include "util.h"
 #include "pwm.h"
+#include "tmr.h"
 
 // *****************************************************************************
 // ************************** Defines ******************************************
@@ -62,6 +63,58 @@
 #define SERVO_PWM_IN_DIV        1000U   ///< Input position division (for Q30 scaling).
 #define SERVO_PWM_IN_SHIFT2        9U   ///< Input position 2nd l-shift (for Q30 scaling).
 
+// Values for division-free scaling of the PWM input.
+//
+// The input position division is performed by multiplication by the 
+// reciprocal, rather than by iterative division:
+//
+//  |pos| * 2^21 / 1000 = |pos| * 2^18 / 125
+//                      = |pos| * 2097 + ( |pos| * 19 ) / 125
+//
+//  ( |pos| * 19 ) / 125 = ( ( |pos| * 19 ) * ceil( 2^21 / 125 ) ) >> 21
+//
+// The reciprocal exceeds 2^21 / 125 by 98 / 125, which does not alter the
+// quotient for ( |pos| * 19 ) less than 2^21 / 98 - i.e. for the valid
+// position range (|pos| <= 1024).  The result is identical to that of the
+// division (rounded towards zero).
+//
+#define SERVO_PWM_IN_MUL_INT    2097U   ///< Input position integer factor (2^18 / 125).
+#define SERVO_PWM_IN_MUL_REM      19U   ///< Input position remainder factor (2^18 % 125).
+#define SERVO_PWM_IN_RECIP     16778UL  ///< Reciprocal of 125 (Q21, rounded up).
+#define SERVO_PWM_IN_RECIP_SHIFT  21U   ///< Reciprocal Q-number.
+
+#if ( SERVO_PWM_IN_SHIFT1 != 21U ) || ( SERVO_PWM_IN_DIV != 1000U )
+#error "Division-free PWM input scaling is defined for a 21-bit l-shift and division by 1000."
+#endif
+
+#if SERVO_PWM_OUT_DIV != 100U
+#error "Division-free PWM output scaling is defined for division by 100 (see UtilDiv100)."
+#endif
+
+// Values for the servo calibration lookup table.
+//
+// The table spans the position range for which the Q30 input scaling is
+// valid (i.e. +/-1.024rad).  Position commands outside of the range are 
+// corrected by evaluation of the polynomial.
+//
+#define SERVO_LUT_POS_MIN       (-1024) ///< Position of the first table entry (LSB = 0.001rad).
+#define SERVO_LUT_POS_MAX         1023  ///< Maximum position corrected by the table (LSB = 0.001rad).
+#define SERVO_LUT_SEG_SHIFT     ( 11U - SERVO_LUT_SIZE_LOG2 )               ///< Segment width r-shift (i.e. width = 2048 >> n).
+#define SERVO_LUT_LEN           ( ( 1U << SERVO_LUT_SIZE_LOG2 ) + 1U )      ///< Number of table entries.
+#define SERVO_LUT_BUILD_LEN       16U   ///< Number of table entries built per execution.
+
+// Values for the inverse calibration (PWM to position) table.
+//
+// The applied PWM is determined at evenly spaced positions over the valid
+// position range (+/-1.024rad).  The position is estimated from the applied
+// PWM by piecewise-linear interpolation of the samples, which requires the
+// calibration to be strictly monotonic over the range.
+//
+#define SERVO_INV_POS_MIN       (-1024) ///< Position of the first sample (LSB = 0.001rad).
+#define SERVO_INV_POS_MAX         1023  ///< Position of the last sample (LSB = 0.001rad).
+#define SERVO_INV_LEN           UTIL_PWL_LEN_MAX    ///< Number of samples.
+#define SERVO_POS_EST_INVALID   INT16_MIN           ///< Position estimate is not available (0x8000).
+
 /// List of servo control/command types.
 typedef enum
 {
@@ -91,92 +144,503 @@ static int16_t servo_cmd_pos = 0;
 
 /// The actual PWM value applied to the servo.
 ///
-/// @note   Updated on execution of module service function.
-static uint16_t servo_act_pwm;
+/// @note   Default to 1500us - i.e. PWM initialization value.  Updated on
+///         reception of a Servo Command and read by the software cycle for
+///         annunciation (16-bit access is atomic).
+static uint16_t servo_act_pwm = 1500;
+
+/// Position command of the previous position correction.
+static int16_t servo_memo_pos;
+
+/// Configuration data generation of the previous position correction (0 -
+/// no correction has been performed).
+static uint16_t servo_memo_gen = 0;
+
+/// Lookup table build count of the previous position correction.
+static uint16_t servo_memo_lut_cnt;
+
+/// PWM value determined by the previous position correction.
+static uint16_t servo_memo_pwm;
+
+/// Number of position commands for which the previous correction was used
+/// (16-bit roll-over counter).
+static uint16_t servo_memo_hit_cnt = 0;
+
+/// Number of position commands for which correction was performed (16-bit
+/// roll-over counter).
+static uint16_t servo_memo_miss_cnt = 0;
+
+/// Maximum Servo Command latency - from the CAN receive interrupt's reading
+/// of the command to its application to the PWM output (LSB = 1 instruction
+/// cycle, saturated at maximum value).
+///
+/// @note   Cumulative maximum, updated by the CAN receive interrupt and read
+///         by the software cycle (16-bit access is atomic).
+static uint16_t servo_cmd_latency_max = 0;
+
+/// Number of lookup table builds completed (16-bit roll-over counter; 0 if
+/// the table is disabled).
+///
+/// @note   Multi-threaded data written by the software cycle and read by the
+///         CAN receive interrupt (16-bit access is atomic).
+static volatile uint16_t servo_lut_build_cnt = 0;
+
+#if SERVO_LUT_ENABLE
+
+/// Servo calibration lookup table - correction polynomial output (prior to
+/// down-scaling) at each segment boundary.
+///
+/// @note   Multi-threaded data written by the software cycle and read by the
+///         CAN receive interrupt.  The table is only read when identified as
+///         valid, and is only written when identified as invalid.
+static int32_t servo_lut[ SERVO_LUT_LEN ];
+
+/// Configuration data generation from which the lookup table is built (0 -
+/// table has not been built).
+///
+/// @note   Multi-threaded data written by the software cycle and read by the
+///         CAN receive interrupt.  The table is only read when built from
+///         the present configuration data generation (see ServoPosCorrect).
+static volatile uint16_t servo_lut_gen = 0;
+
+/// Identification of the lookup table being complete.
+static volatile bool servo_lut_valid = false;
+
+/// Index of the next lookup table entry to build.
+static uint16_t servo_lut_build_idx = 0;
+
+#endif
+
+/// Inverse calibration table - position (LSB = 0.001rad) by applied PWM
+/// (LSB = 1us).
+static UTIL_PWL_S servo_inv;
+
+/// Configuration data generation from which the inverse calibration table 
+/// is built (0 - table has not been built).
+static uint16_t servo_inv_gen = 0;
 
 // *****************************************************************************
 // ************************** Function Prototypes ******************************
 // *****************************************************************************
 
+static int32_t ServoPosCorrect( int16_t cmd_pos );
+static void ServoInvBuild( void );
+static int16_t ServoPosEstimate( uint16_t act_pwm );
+
+/// Servo position correction polynomial evaluator (specialized UtilPoly32).
+UTIL_POLY32_DEFINE( ServoPoly, SERVO_QNUM_CALC, CFG_PWM_COEFF_LEN )
+
 // *****************************************************************************
 // ************************** Global Functions *********************************
 // *****************************************************************************
 
 void ServoService ( void )
 {
-    // CAN message transmitted ever software cycle (10ms).
-    static const uint16_t can_tx_period  = 1;
-    static       uint16_t can_tx_timeout = 0;
-    
     CAN_RX_SERVO_CMD_U    servo_cmd_msg;
-    CAN_TX_SERVO_STATUS_U servo_status_msg;
-    
-    int32_t servo_coeff[ CFG_PWM_COEFF_LEN ];
     
-    int32_t servo_cmd_pos_in;
-    int32_t servo_act_pwm_i32;
+    int32_t  servo_act_pwm_i32;
+    uint16_t cfg_gen;
+    uint16_t lut_cnt;
+    uint32_t latency;
     
     bool payload_valid;
     
-    // Get the Servo Command CAN data.
+    // Get the oldest queued Servo Command CAN data.
     payload_valid = CANRxGet( CAN_RX_MSG_SERVO_CMD, servo_cmd_msg.data_u16 );
     
     // Servo Command CAN message received ?
-    if( payload_valid == true )
+    //
+    // Note: The CAN receive interrupt is also triggered by other message 
+    // types, in which case the applied PWM is unchanged.
+    //
+    // Note: Each queued command is applied in order of reception, so that a
+    // burst of commands received within one interrupt is not reordered.
+    //
+    while( payload_valid == true )
     {
         // Update module data with that received.
         servo_cmd_type = servo_cmd_msg.cmd_type;
         servo_cmd_pwm  = servo_cmd_msg.cmd_pwm;
         servo_cmd_pos  = servo_cmd_msg.cmd_pos;
+        
+        // Position command is being used for control ?
+        if( servo_cmd_type == SERVO_CTRL_POS )
+        {
+            cfg_gen = CfgGenGet();
+            lut_cnt = servo_lut_build_cnt;
+            
+            // Position command, configuration data and lookup table are
+            // unchanged since the previous correction ?
+            //
+            // Note: The table build count is compared since completion of
+            // the table changes the correction from evaluation of the
+            // polynomial to interpolation of the table.
+            //
+            if( ( servo_cmd_pos == servo_memo_pos     ) &&
+                ( cfg_gen       == servo_memo_gen     ) &&
+                ( lut_cnt       == servo_memo_lut_cnt ) )
+            {
+                // Use the result of the previous correction.
+                servo_act_pwm = servo_memo_pwm;
+                
+                servo_memo_hit_cnt++;
+            }
+            else
+            {
+                // Perform correction of position commanded value.
+                servo_act_pwm_i32 = ServoPosCorrect( servo_cmd_pos );
+
+                // Down-scale and typecast value back to integer type (micro-sec LSB).
+                servo_act_pwm = (uint16_t) UtilDiv100( servo_act_pwm_i32 );
+                
+                // Retain the correction for subsequent commands.
+                servo_memo_pos     = servo_cmd_pos;
+                servo_memo_gen     = cfg_gen;
+                servo_memo_lut_cnt = lut_cnt;
+                servo_memo_pwm     = servo_act_pwm;
+                
+                servo_memo_miss_cnt++;
+            }
+        }
+        else
+        {
+            // Commanded PWM is used directly for control.
+            servo_act_pwm = servo_cmd_pwm;                                       
+        }
+        
+        // Update PWM duty cycle with that determined.
+        PWMDutySet( servo_act_pwm );
+        
+        // Measure the command latency from the time of the command's queuing.
+        //
+        // Note: Commands queued by one interrupt share the time of queuing;
+        // therefore, the latency of the later commands of a burst includes
+        // the application of the earlier commands.
+        //
+        latency = TMRTickGet() - CANRxTickGet( CAN_RX_MSG_SERVO_CMD );
+        if( latency > servo_cmd_latency_max )
+        {
+            servo_cmd_latency_max = ( latency < UINT16_MAX ) ? (uint16_t) latency : UINT16_MAX;
+        }
+        
+        // Get the next queued Servo Command CAN data.
+        payload_valid = CANRxGet( CAN_RX_MSG_SERVO_CMD, servo_cmd_msg.data_u16 );
     }
+}
+
+void ServoStatusService ( void )
+{
+    CAN_TX_SERVO_STATUS_U* servo_status_msg;
+    CAN_TX_SERVO_POS_U*    servo_pos_msg;
+    
+    uint16_t act_pwm;
+    
+    // Note: The applied PWM is read once, so that both messages annunciate
+    // the same value.
+    act_pwm = servo_act_pwm;
     
-    // Position command is being used for control ?
-    if( servo_cmd_type == SERVO_CTRL_POS )
+    // Construct the Servo Status CAN message in place within the transmit
+    // queue.
+    servo_status_msg = (CAN_TX_SERVO_STATUS_U*) CANTxAcquire( CAN_TX_MSG_SERVO_STATUS );
+    
+    // Transmit queue is not full ?
+    if( servo_status_msg != NULL )
     {
-        // Get servo polynomial coefficient correction values.
-        CfgPWMCoeffGet( &servo_coeff[ 0 ] );
-        
-        // Note: Implementation defined behavior.  Shift operators retain the sign.
-        servo_cmd_pos_in = ((int32_t) servo_cmd_pos) << SERVO_PWM_IN_SHIFT1;    // up-scale to maximize storage in int32_t.
-        servo_cmd_pos_in = servo_cmd_pos_in / SERVO_PWM_IN_DIV;                 // remove base_10 scaling.
-        servo_cmd_pos_in = servo_cmd_pos_in << SERVO_PWM_IN_SHIFT2;             // up-scale to Q30 representation.
-        
-        // Perform correction of position commanded value.
-        servo_act_pwm_i32 = UtilPoly32( servo_cmd_pos_in,
-                                        SERVO_QNUM_CALC,
-                                        &servo_coeff[ 0 ], 
-                                        CFG_PWM_COEFF_LEN );
+        servo_status_msg->cmd_type_echo = servo_cmd_type;
+        servo_status_msg->pwm_act       = act_pwm;
+        servo_status_msg->servo_voltage = INA219VoltGet();
+        servo_status_msg->servo_current = INA219AmpGet();
         
-        // Down-scale and typecast value back to integer type (micro-sec LSB).
-        servo_act_pwm = (uint16_t) ( servo_act_pwm_i32 / SERVO_PWM_OUT_DIV );
+        // Send the CAN message.
+        CANTxCommit( CAN_TX_MSG_SERVO_STATUS );
     }
-    else
+    
+    // Configuration data has changed since the inverse calibration table was
+    // built (or the table has not been built) ?
+    if( servo_inv_gen != CfgGenGet() )
     {
-        // Commanded PWM is used directly for control.
-        servo_act_pwm = servo_cmd_pwm;                                       
+        ServoInvBuild();
     }
     
-    // Update PWM duty cycle with that determined.
-    PWMDutySet( servo_act_pwm );
+    // Construct the Servo Position CAN message in place within the transmit
+    // queue.
+    servo_pos_msg = (CAN_TX_SERVO_POS_U*) CANTxAcquire( CAN_TX_MSG_SERVO_POS );
     
-    // timeout has elapsed since last CAN message transmission.
-    can_tx_timeout++;
-    if( can_tx_timeout >= can_tx_period )
+    // Transmit queue is not full ?
+    if( servo_pos_msg != NULL )
     {
-        // reset timeout
-        can_tx_timeout = 0;
+        servo_pos_msg->pos_est = ServoPosEstimate( act_pwm );
+        servo_pos_msg->pwm_act = act_pwm;
         
-        // Construct the Servo Status CAN message.
-        servo_status_msg.cmd_type_echo = servo_cmd_type;
-        servo_status_msg.pwm_act       = servo_act_pwm;
-        servo_status_msg.servo_voltage = INA219VoltGet();
-        servo_status_msg.servo_current = INA219AmpGet();
-
         // Send the CAN message.
-        CANTxSet( CAN_TX_MSG_SERVO_STATUS, servo_status_msg.data_u16 );
+        CANTxCommit( CAN_TX_MSG_SERVO_POS );
     }
 }
 
+void ServoMemoCntGet ( uint16_t* hit_cnt, uint16_t* miss_cnt )
+{
+    // Note: Counters are updated by the CAN receive interrupt.  Each 16-bit
+    // read is atomic, but the two counters may be read across an update.
+    *hit_cnt  = servo_memo_hit_cnt;
+    *miss_cnt = servo_memo_miss_cnt;
+}
+
+uint16_t ServoLatencyMaxGet ( void )
+{
+    return servo_cmd_latency_max;
+}
+
+void ServoLutService ( void )
+{
+#if SERVO_LUT_ENABLE
+    int32_t  entry_pos_in;
+    uint16_t build_cnt;
+    uint16_t cfg_gen;
+    
+    // Configuration data has changed since the table was built (or the table
+    // has not been built) ?
+    //
+    // Note: A Servo Command received between the update of the coefficients
+    // and their detection is not corrected with the table of the previous
+    // coefficients, since the table is only used when built from the 
+    // present configuration data generation (see ServoPosCorrect).
+    //
+    cfg_gen = CfgGenGet();
+    
+    if( cfg_gen != servo_lut_gen )
+    {
+        // Invalidate the table prior to updating it, so that the table is
+        // not used while partially built.
+        servo_lut_valid     = false;
+        servo_lut_build_idx = 0;
+        servo_lut_gen       = cfg_gen;
+    }
+    
+    // Table is not complete ?
+    if( servo_lut_valid == false )
+    {
+        // Build the next set of table entries.
+        for( build_cnt = 0;
+             ( build_cnt < SERVO_LUT_BUILD_LEN ) && ( servo_lut_build_idx < SERVO_LUT_LEN );
+             build_cnt++ )
+        {
+            // Scale the entry's position to Q30 representation.
+            //
+            // Note: 64-bit calculation is used since the position of the last
+            // entry (+1.024rad) exceeds the range of the 32-bit scaling
+            // performed for position commands.
+            //
+            entry_pos_in = (int32_t) ( ( ( (int64_t) SERVO_LUT_POS_MIN + 
+                                           ( (int32_t) servo_lut_build_idx << SERVO_LUT_SEG_SHIFT ) ) 
+                                         << SERVO_QNUM_CALC ) / SERVO_PWM_IN_DIV );
+            
+            servo_lut[ servo_lut_build_idx ] = ServoPoly( entry_pos_in,
+                                                          CfgPWMCoeffGet() );
+            servo_lut_build_idx++;
+        }
+        
+        // Table is complete ?
+        //
+        // Note: The build count is incremented after the table is identified
+        // as valid, so that a correction retained by the CAN receive
+        // interrupt in between (i.e. from the table, with the previous count)
+        // is only repeated, rather than a polynomial correction being
+        // retained with the present count.
+        //
+        if( servo_lut_build_idx >= SERVO_LUT_LEN )
+        {
+            servo_lut_valid = true;
+            servo_lut_build_cnt++;
+        }
+    }
+#endif
+}
+
 // *****************************************************************************
 // ************************** Static Functions *********************************
 // *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Perform correction of a position command.
+///
+/// @param  cmd_pos
+///             The position command (LSB = 0.001rad).
+///
+/// @return The correction output (prior to down-scaling).
+///
+/// @note   If the piecewise-linear calibration is selected, the position 
+///         command is corrected by the configured breakpoints.  Otherwise,
+///         if the lookup table is enabled, complete and built from the 
+///         present configuration data, correction of position commands
+///         within its range is performed by linear interpolation of the 
+///         table.  Otherwise, the polynomial is evaluated.
+///
+/// @note   The correction is therefore determined by the present 
+///         configuration data and the completion of the lookup table, so
+///         that it may be retained for the present configuration data
+///         generation and table build count (see ServoService).
+////////////////////////////////////////////////////////////////////////////////
+static int32_t ServoPosCorrect( int16_t cmd_pos )
+{
+    int32_t  servo_cmd_pos_in;
+    int16_t  pos_wrap;
+    uint16_t pos_abs;
+    uint32_t pos_scl;
+    int32_t  result;
+    
+#if SERVO_LUT_ENABLE
+    uint16_t lut_pos;
+    uint16_t lut_idx;
+    uint16_t lut_frac;
+#endif
+    
+    // Piecewise-linear calibration is selected ?
+    if( CfgPWMCalTypeGet() == CFG_CAL_PWL )
+    {
+        result = UtilPwl( cmd_pos, CfgPWMPwlGet() );
+    }
+#if SERVO_LUT_ENABLE
+    // Lookup table is complete, is built from the present configuration 
+    // data, and position is within the table's range ?
+    //
+    // Note: The generation is compared so that a command received after an
+    // update of the coefficients, but before the table is invalidated by the
+    // software cycle, is not corrected with the previous coefficients.
+    //
+    else if( ( servo_lut_valid == true                ) &&
+             ( servo_lut_gen   == CfgGenGet()         ) &&
+             ( cmd_pos         >= SERVO_LUT_POS_MIN   ) &&
+             ( cmd_pos         <= SERVO_LUT_POS_MAX   ) )
+    {
+        // Determine the table segment and the position within the segment.
+        lut_pos  = (uint16_t) ( cmd_pos - SERVO_LUT_POS_MIN );
+        lut_idx  = lut_pos >> SERVO_LUT_SEG_SHIFT;
+        lut_frac = lut_pos & ( ( 1U << SERVO_LUT_SEG_SHIFT ) - 1U );
+        
+        // Linearly interpolate between the segment's boundary entries.
+        // ~ 64-bit multiplication performed, since the difference of entries
+        //   is not bounded by the coefficients' configuration.
+        result = servo_lut[ lut_idx ] + 
+                 (int32_t) ( ( ( (int64_t) servo_lut[ lut_idx + 1 ] - servo_lut[ lut_idx ] ) * lut_frac )
+                             >> SERVO_LUT_SEG_SHIFT );
+    }
+#endif
+    else
+    {
+        // Limit the position to the range of the 1st l-shift (i.e. 11-bit
+        // signed), to which position commands outside of the valid range 
+        // (+/-1.024rad) were wrapped by the former l-shift scaling.
+        //
+        // Note: Implementation defined behavior.  Shift operators retain the sign.
+        //
+        pos_wrap = (int16_t) ( (uint16_t) cmd_pos << ( 16U - 11U ) ) >> ( 16U - 11U );
+        pos_abs  = ( pos_wrap < 0 ) ? (uint16_t) -pos_wrap : (uint16_t) pos_wrap;
+        
+        // Up-scale and remove base_10 scaling (see SERVO_PWM_IN_RECIP).
+        pos_scl = ( (uint32_t) pos_abs * SERVO_PWM_IN_MUL_INT ) +
+                  ( ( (uint32_t) ( pos_abs * SERVO_PWM_IN_MUL_REM ) * SERVO_PWM_IN_RECIP ) 
+                    >> SERVO_PWM_IN_RECIP_SHIFT );
+        
+        // Up-scale to Q30 representation.
+        servo_cmd_pos_in = (int32_t) ( pos_scl << SERVO_PWM_IN_SHIFT2 );
+        if( pos_wrap < 0 )
+        {
+            servo_cmd_pos_in = -servo_cmd_pos_in;
+        }
+        
+        // Perform correction of position commanded value.
+        result = ServoPoly( servo_cmd_pos_in, CfgPWMCoeffGet() );
+    }
+    
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Build the inverse calibration table.
+///
+/// The PWM applied for each sampled position is determined by the position
+/// correction, and the samples are ordered by increasing PWM.  The table is
+/// invalid if the PWM is not strictly monotonic over the sampled positions 
+/// (see UtilPwlInit).
+///
+/// @note   Function is executed by the software cycle, and is preempted by 
+///         the position correction of the CAN receive interrupt.  The
+///         position correction does not modify module data, so that both
+///         threads may perform it.
+////////////////////////////////////////////////////////////////////////////////
+static void ServoInvBuild( void )
+{
+    int16_t  inv_pwm[ SERVO_INV_LEN ];
+    int32_t  inv_pos[ SERVO_INV_LEN ];
+    int16_t  sample_pos[ SERVO_INV_LEN ];
+    uint16_t sample_pwm[ SERVO_INV_LEN ];
+    uint8_t  sample_idx;
+    uint8_t  inv_idx;
+    uint8_t  inv_len = SERVO_INV_LEN;
+    
+    servo_inv_gen = CfgGenGet();
+    
+    // Determine the applied PWM (as performed on reception of a position
+    // command) for each sampled position.
+    for( sample_idx = 0;
+         sample_idx < SERVO_INV_LEN;
+         sample_idx++ )
+    {
+        sample_pos[ sample_idx ] = (int16_t) ( SERVO_INV_POS_MIN + 
+                                               ( ( (int32_t) sample_idx * ( SERVO_INV_POS_MAX - SERVO_INV_POS_MIN ) ) /
+                                                 ( SERVO_INV_LEN - 1U ) ) );
+        sample_pwm[ sample_idx ] = (uint16_t) UtilDiv100( ServoPosCorrect( sample_pos[ sample_idx ] ) );
+        
+        // PWM exceeds the range of the table's breakpoint inputs ?
+        if( sample_pwm[ sample_idx ] > INT16_MAX )
+        {
+            inv_len = 0;
+        }
+    }
+    
+    // Order the samples by increasing PWM - i.e. reverse the samples if the
+    // PWM decreases with position.
+    for( sample_idx = 0;
+         sample_idx < SERVO_INV_LEN;
+         sample_idx++ )
+    {
+        inv_idx = ( sample_pwm[ SERVO_INV_LEN - 1U ] >= sample_pwm[ 0 ] ) ? 
+                        sample_idx : 
+                        ( SERVO_INV_LEN - 1U ) - sample_idx;
+        
+        inv_pwm[ inv_idx ] = (int16_t) sample_pwm[ sample_idx ];
+        inv_pos[ inv_idx ] = sample_pos[ sample_idx ];
+    }
+    
+    // Determine the interpolation slopes.
+    //
+    // Note: The table is identified as invalid (i.e. zero length) if the
+    // samples are not strictly increasing.
+    //
+    (void) UtilPwlInit( &servo_inv, inv_pwm, inv_pos, inv_len );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Estimate the servo position from the applied PWM.
+///
+/// @param  act_pwm
+///             The applied PWM (LSB = 1us).
+///
+/// @return The estimated position (LSB = 0.001rad), or SERVO_POS_EST_INVALID
+///         if the inverse calibration table is invalid or the PWM is outside
+///         of the table's range.
+////////////////////////////////////////////////////////////////////////////////
+static int16_t ServoPosEstimate( uint16_t act_pwm )
+{
+    int16_t result = SERVO_POS_EST_INVALID;
+    
+    // Inverse calibration table is valid and PWM is within the table's range ?
+    if( ( servo_inv.len != 0                                       ) &&
+        ( (int32_t) act_pwm >= servo_inv.x[ 0 ]                    ) &&
+        ( (int32_t) act_pwm <= servo_inv.x[ servo_inv.len - 1U ]   ) )
+    {
+        result = (int16_t) UtilPwl( (int16_t) act_pwm, &servo_inv );
+    }
+    
+    return result;
+}
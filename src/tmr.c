@@ -12,27 +12,45 @@
 // *****************************************************************************
 
 #include "tmr.h"
+#include "util.h"
 
 // *****************************************************************************
 // ************************** Defines ******************************************
 // *****************************************************************************
 
+/// Roll-over period of the 32-bit instruction cycle counter (2^32 cycles)
+/// divided by the micro-second and 0.1ms periods - quotient and remainder
+/// (see TMRUsGet and TMR2p1msGet).
+#define TMR_ROLL_US_QUOT        214748364UL     ///< 2^32 / 20
+#define TMR_ROLL_US_REM         16U             ///< 2^32 % 20
+#define TMR_ROLL_100US_QUOT     2147483UL       ///< 2^32 / 2000
+#define TMR_ROLL_100US_REM      1296U           ///< 2^32 % 2000
+
+#if TMR_CYC_PER_US != 20U
+#error "Division-free timestamp scaling is defined for 20 instruction cycles per micro-second."
+#endif
+
 // *****************************************************************************
 // ************************** Definitions **************************************
 // *****************************************************************************
 
-/// Timer2 0.1ms up-counter with roll-over.
+/// Number of roll-overs of the 32-bit instruction cycle counter (16-bit
+/// roll-over counter).
 ///
-/// @note   Multi-threaded data services every 0.1ms and accessible through
-///         accessor function.
-static volatile uint16_t tmr2_p1ms_cnt = 0;
+/// @note   Multi-threaded data incremented by the Timer3 interrupt and read
+///         with interrupts disabled (see TMRTickExtGet).
+static volatile uint16_t tmr_tick_roll_cnt;
 
 // *****************************************************************************
 // ************************** Function Prototypes ******************************
 // *****************************************************************************
 
 static void TMR1Init( void );
-static void TMR2Init( void );
+static void TMR23Init( void );
+static void TMR4Init( void );
+static void TMRTickExtGet( uint16_t* roll_cnt, uint32_t* tick );
+static uint32_t TMRDiv20( uint32_t dividend );
+static uint32_t TMRDiv2000( uint32_t dividend );
 
 // *****************************************************************************
 // ************************** Global Functions *********************************
@@ -41,7 +59,8 @@ static void TMR2Init( void );
 void TMRInit ( void )
 {
     TMR1Init();
-    TMR2Init();
+    TMR23Init();
+    TMR4Init();
 }
 
 void TMR1Enable ( void )
@@ -62,18 +81,121 @@ void TMR1Service ( void )
     IFS0bits.T1IF = 0; 
 }
 
-void TMR2Service ( void )
+uint16_t TMR1Get ( void )
 {
-    // Clear the hardware interrupt flag.
-    IFS0bits.T2IF = 0; 
-    
-    // Increment the counter (16-bit roll-over counter).
-    tmr2_p1ms_cnt++;
+    return TMR1;
+}
+
+bool TMR1FlagGet ( void )
+{
+    return ( IFS0bits.T1IF == 1 );
+}
+
+void TMR4OneShotStart ( void )
+{
+    TMR4            = 0;        // Clear timer value register.
+    IFS1bits.T4IF   = 0;        // Clear Timer 4 interrupt flag.
+    IEC1bits.T4IE   = 1;        // Enable Timer 4 interrupt.
+    T4CONbits.TON   = 1;        // Enable Timer.
+}
+
+void TMR4Service ( void )
+{
+    // Stop the timer so that the interrupt is triggered only once.
+    T4CONbits.TON   = 0;
+    IEC1bits.T4IE   = 0;
+    IFS1bits.T4IF   = 0;
+}
+
+void TMR23Service ( void )
+{
+    // Count the roll-over and clear the hardware interrupt flag.
+    //
+    // Note: Interrupts are disabled so that a higher priority interrupt 
+    // thread reading the extended counter does not observe the roll-over
+    // both counted and pending (see TMRTickExtGet).
+    //
+    __builtin_disi( 0x3FFF );
+    tmr_tick_roll_cnt++;
+    IFS0bits.T3IF = 0;
+    __builtin_disi( 0 );
 }
 
 uint16_t TMR2p1msGet ( void )
 {
-    return tmr2_p1ms_cnt;
+    uint16_t roll_cnt;
+    uint32_t tick;
+    uint32_t tick_quot;
+    uint32_t tick_rem;
+    
+    // Scale the extended instruction cycle counter to the 0.1ms resolution
+    // (i.e. 2000 instruction cycles per 0.1ms), without 64-bit division:
+    //
+    //      ( roll_cnt * 2^32 + tick ) / 2000
+    //          = roll_cnt * ( 2^32 / 2000 ) + ( tick / 2000 ) +
+    //            ( ( roll_cnt * ( 2^32 % 2000 ) ) + ( tick % 2000 ) ) / 2000
+    //
+    // Note: The extended counter is used so that the 0.1ms counter is 
+    // continuous through the roll-over of the 32-bit counter.  The sum is
+    // computed modulo 2^32, which is exact for the 16-bit result.
+    //
+    TMRTickExtGet( &roll_cnt, &tick );
+    
+    tick_quot = TMRDiv2000( tick );
+    tick_rem  = tick - ( tick_quot * 2000U );
+    
+    return (uint16_t) ( ( (uint32_t) roll_cnt * TMR_ROLL_100US_QUOT ) + tick_quot +
+                        TMRDiv2000( ( (uint32_t) roll_cnt * TMR_ROLL_100US_REM ) + tick_rem ) );
+}
+
+uint32_t TMRTickGet ( void )
+{
+    uint16_t tick_lo;
+    uint16_t tick_hi;
+    
+    // Read the 32-bit counter - reading the Timer2 (lsw) register latches
+    // the Timer3 (msw) register into the holding register, so that the two
+    // words are coherent.
+    //
+    // Note: Interrupts are disabled so that an interrupt thread reading the
+    // counter does not overwrite the holding register between the two reads.
+    //
+    __builtin_disi( 0x3FFF );
+    tick_lo = TMR2;
+    tick_hi = TMR3HLD;
+    __builtin_disi( 0 );
+    
+    return ( ( (uint32_t) tick_hi ) << 16 ) | tick_lo;
+}
+
+uint32_t TMRUsGet ( void )
+{
+    uint16_t roll_cnt;
+    uint32_t tick;
+    uint32_t tick_quot;
+    uint32_t tick_rem;
+    
+    // Scale the extended instruction cycle counter to the micro-second
+    // resolution, without 64-bit division (see TMR2p1msGet).
+    //
+    // Note: The extended counter is used so that the timestamp is 
+    // continuous through the roll-over of the 32-bit counter.
+    //
+    TMRTickExtGet( &roll_cnt, &tick );
+    
+    tick_quot = TMRDiv20( tick );
+    tick_rem  = tick - ( tick_quot * TMR_CYC_PER_US );
+    
+    return ( (uint32_t) roll_cnt * TMR_ROLL_US_QUOT ) + tick_quot +
+           TMRDiv20( ( (uint32_t) roll_cnt * TMR_ROLL_US_REM ) + tick_rem );
+}
+
+uint16_t TMRCycleGet ( void )
+{
+    // Note: Reading the Timer2 register latches the Timer3 holding register,
+    // which does not affect a coherent read of the 32-bit counter since a 
+    // 32-bit read is performed with interrupts disabled.
+    return TMR2;
 }
 
 // *****************************************************************************
@@ -86,8 +208,9 @@ uint16_t TMR2p1msGet ( void )
 static void TMR1Init( void )
 {
     // Timer 1 is operated in 'Timer Mode' - the free-running timer is
-    // configured to trigger an interrupt ever 10ms.  This is performed to
-    // drive the software executive 10ms processing thread.
+    // configured to trigger an interrupt every software cycle period
+    // (TMR_FRAME_PERIOD_US).  This is performed to drive the software 
+    // executive processing thread.
     //
     // Timer 1 is fed by the instruction/peripheral clock (Fp), see
     // datasheet p. 123.
@@ -96,9 +219,17 @@ static void TMR1Init( void )
     //          = 20MHz
     //
     // Ft1int   = ( Fp    / Prescale ) / ( PR1   + 1 )
-    //          = ( 20Mhz / 8        ) / ( 24999 + 1 )
+    //          = ( 20Mhz / 8        ) / ( 24999 + 1 )  ( 10ms period)
     //          = 100Hz
     //
+    //          = ( 20Mhz / 8        ) / ( 6249  + 1 )  (2.5ms period)
+    //          = 400Hz
+    //
+    // Note: The period value is derived from the period in instruction
+    // cycles (TMR1_PERIOD_CYC) so that software which measures the period
+    // uses a consistent value.  All supported periods yield a period value
+    // within the 16-bit range with a prescale of 8.
+    //
     // Note: timer configured (TSIDL) for continuous operation in idle mode.
     // Idle mode is not performed by the CPU; therefore, this setting is purely 
     // for robustness.
@@ -112,7 +243,7 @@ static void TMR1Init( void )
     T1CONbits.TCKPS = 0b01;     // Select prescale = 8.
     
     TMR1            = 0;        // Clear timer value register.
-    PR1             = 24999;    // Set the period value.
+    PR1             = ( TMR1_PERIOD_CYC / TMR1_PRESCALE ) - 1;  // Set the period value.
     
     IPC0bits.T1IP   = 1;        // Select Timer 1 interrupt priority level.
     IFS0bits.T1IF   = 0;        // Clear Timer 1 interrupt flag.
@@ -120,42 +251,180 @@ static void TMR1Init( void )
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief  Initialize Timer 2 hardware configuration.
+/// @brief  Initialize Timer 2/3 hardware configuration.
 ////////////////////////////////////////////////////////////////////////////////
-static void TMR2Init( void )
+static void TMR23Init( void )
 {
-    // Timer 2 is operated in 'Timer Mode' - the free-running timer is
-    // configured to provide a 0.1ms counter.
+    // Timer 2/3 is operated in '32-bit Timer Mode' - the free-running timer
+    // is configured to count instruction cycles.  This is performed to
+    // provide a time reference for determining relative time and for 
+    // measurement of software execution time.  The counter is read on
+    // demand, rather than maintained by a periodic interrupt.
     //
-    // Timer 2 is fed by the instruction/peripheral clock (Fp), see
-    // datasheet p. 123.
+    // Timer 2/3 is fed by the instruction/peripheral clock (Fp), see
+    // datasheet p. 123.  In 32-bit mode, Timer 2 is the lsw and Timer 3 is
+    // the msw - the timer is configured with the Timer 2 registers, and the
+    // interrupt is controlled with the Timer 3 registers.  The interrupt is
+    // triggered at each roll-over of the counter (i.e. every ~214.7s) to
+    // extend the counter for the 0.1ms and micro-second timestamps.
     // 
     // Fp       = Fosc / 2                              
     //          = 20MHz
     //
-    // Ft1int   = ( Fp    / Prescale ) / ( PR1 + 1 )
-    //          = ( 20Mhz / 8        ) / ( 249 + 1 )
-    //          = 10KHz
+    // Ft23cnt  = Fp    / Prescale
+    //          = 20Mhz / 1
+    //          = 20MHz
+    //
+    // Tt23roll = ( PR3:PR2    + 1 ) / Ft23cnt
+    //          = ( 0xFFFFFFFF + 1 ) / 20MHz
+    //          = ~214.7s
     //
     // Note: timer configured (TSIDL) for continuous operation in idle mode.
     // Idle mode is not performed by the CPU; therefore, this setting is purely 
     // for robustness.
     //
     T2CONbits.TON   = 0;        // Disable Timer.
+    T3CONbits.TON   = 0;        // Disable Timer.
     T2CONbits.TCS   = 0;        // Select internal instruction cycle clock.
     T2CONbits.TGATE = 0;        // Select Timer (i.e. not Gated) mode.
-    T2CONbits.T32   = 0;        // Select 16-bit timer.
+    T2CONbits.T32   = 1;        // Select 32-bit timer.
     
     T2CONbits.TSIDL = 0;        // Select continuous operation in idle mode.
     
-    T2CONbits.TCKPS = 0b01;     // Select prescale = 8.
+    T2CONbits.TCKPS = 0b00;     // Select prescale = 1.
     
-    TMR2            = 0;        // Clear timer value register.
-    PR2             = 249;      // Set the period value.
+    TMR3            = 0;        // Clear timer value register (msw).
+    TMR2            = 0;        // Clear timer value register (lsw).
+    PR3             = 0xFFFF;   // Set the period value (msw) - full 32-bit range.
+    PR2             = 0xFFFF;   // Set the period value (lsw) - full 32-bit range.
     
-    IPC1bits.T2IP   = 2;        // Select Timer 2 interrupt priority level.
     IFS0bits.T2IF   = 0;        // Clear Timer 2 interrupt flag.
-    IEC0bits.T2IE   = 1;        // Enable Time 2 interrupt.
+    IEC0bits.T2IE   = 0;        // Disable Timer 2 interrupt - N/A in 32-bit mode.
+    IPC2bits.T3IP   = 1;        // Select Timer 3 interrupt priority level.
+    IFS0bits.T3IF   = 0;        // Clear Timer 3 interrupt flag.
+    IEC0bits.T3IE   = 1;        // Enable Timer 3 interrupt - roll-over count.
     
     T2CONbits.TON   = 1;        // Enable Timer.
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Initialize Timer 4 hardware configuration.
+////////////////////////////////////////////////////////////////////////////////
+static void TMR4Init( void )
+{
+    // Timer 4 is operated in 'Timer Mode' as a one-shot timer - the timer
+    // is started on demand (see TMR4OneShotStart) and is stopped by its 
+    // interrupt after one software cycle period (TMR1_PERIOD_CYC).  This is
+    // performed to terminate the background thread calibration without 
+    // polling of a timer by the calibrated loop.
+    //
+    // Timer 4 is configured identically to Timer 1 (prescale = 8), so that
+    // the one-shot period is the Timer 1 period.
+    //
+    // Note: Timer 4 is operated in 16-bit mode (i.e. not paired with 
+    // Timer 5).
+    //
+    T4CONbits.TON   = 0;        // Disable Timer.
+    T4CONbits.TCS   = 0;        // Select internal instruction cycle clock.
+    T4CONbits.TGATE = 0;        // Select Timer (i.e. not Gated) mode.
+    T4CONbits.T32   = 0;        // Select 16-bit timer.
+    
+    T4CONbits.TSIDL = 0;        // Select continuous operation in idle mode.
+    
+    T4CONbits.TCKPS = 0b01;     // Select prescale = 8.
+    
+    TMR4            = 0;        // Clear timer value register.
+    PR4             = ( TMR1_PERIOD_CYC / TMR1_PRESCALE ) - 1;  // Set the period value.
+    
+    IPC6bits.T4IP   = 1;        // Select Timer 4 interrupt priority level.
+    IFS1bits.T4IF   = 0;        // Clear Timer 4 interrupt flag.
+    IEC1bits.T4IE   = 0;        // Disable Timer 4 interrupt - enabled on start.
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return extended instruction cycle counter.
+///
+/// The 48-bit instruction cycle counter value (LSB = 1 instruction cycle) is
+/// the 32-bit counter extended by its roll-over count:
+///
+///     roll_cnt * 2^32 + tick
+///
+/// @param  roll_cnt
+///             The roll-over count of the 32-bit counter.
+/// @param  tick
+///             The 32-bit counter value.
+///
+/// @note   A roll-over of the 32-bit counter which is not yet counted by the
+///         Timer3 interrupt (i.e. the interrupt is pending or the function is
+///         executed by a higher priority interrupt) is identified by the 
+///         interrupt flag.  The flag is only considered with a counter value
+///         in the lower half of its range, since the flag is set at the 
+///         roll-over.
+////////////////////////////////////////////////////////////////////////////////
+static void TMRTickExtGet( uint16_t* roll_cnt, uint32_t* tick )
+{
+    uint16_t tick_lo;
+    uint16_t tick_hi;
+    
+    // Read the 32-bit counter and the roll-over count coherently (see 
+    // TMRTickGet).
+    __builtin_disi( 0x3FFF );
+    tick_lo   = TMR2;
+    tick_hi   = TMR3HLD;
+    *roll_cnt = tmr_tick_roll_cnt;
+    
+    if( ( IFS0bits.T3IF == 1 ) && 
+        ( tick_hi < 0x8000U  ) )
+    {
+        (*roll_cnt)++;
+    }
+    __builtin_disi( 0 );
+    
+    *tick = ( ( (uint32_t) tick_hi ) << 16 ) | tick_lo;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Division of a 32-bit unsigned variable by 20.
+///
+/// The division is performed by multiplication by the reciprocal (see
+/// UtilDiv100):
+///
+///     dividend / 20 = ( dividend >> 2 ) / 5
+///                   = ( ( dividend >> 2 ) * ceil( 2^32 / 5 ) ) >> 32
+///
+/// The reciprocal exceeds 2^32 / 5 by 4 / 5, which does not alter the
+/// quotient for ( dividend >> 2 ) less than 2^30 - i.e. for all 32-bit
+/// dividends.
+///
+/// @param  dividend
+///             The dividend.
+///
+/// @return The quotient, rounded towards zero.
+////////////////////////////////////////////////////////////////////////////////
+static uint32_t TMRDiv20( uint32_t dividend )
+{
+    return (uint32_t) UtilMulQ32( (int32_t) ( dividend >> 2 ), 858993460L, 32U );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Division of a 32-bit unsigned variable by 2000.
+///
+/// The division is performed by multiplication by the reciprocal (see
+/// UtilDiv100):
+///
+///     dividend / 2000 = ( dividend >> 4 ) / 125
+///                     = ( ( ( dividend >> 4 ) * ceil( 2^37 / 125 ) ) >> 32 ) >> 5
+///
+/// The reciprocal exceeds 2^37 / 125 by 28 / 125, which does not alter the
+/// quotient for ( dividend >> 4 ) less than 2^37 / 28 - i.e. for all 32-bit
+/// dividends.  (The 2^32 scaled reciprocal is not sufficiently precise.)
+///
+/// @param  dividend
+///             The dividend.
+///
+/// @return The quotient, rounded towards zero.
+////////////////////////////////////////////////////////////////////////////////
+static uint32_t TMRDiv2000( uint32_t dividend )
+{
+    return (uint32_t) UtilMulQ32( (int32_t) ( dividend >> 4 ), 1099511628L, 32U ) >> 5;
 }
\ No newline at end of file
@@ -30,118 +30,181 @@
 // ************************** Function Prototypes ******************************
 // *****************************************************************************
 
-static int32_t UtilPow( int32_t var_in, uint8_t calc_qnum, uint8_t power );
-
 // *****************************************************************************
 // ************************** Global Functions *********************************
 // *****************************************************************************
 
 int32_t UtilPoly32( int32_t var_in,
                     uint8_t calc_qnum,
-                    int32_t coeff[], 
+                    const int32_t coeff[], 
                     uint8_t coeff_len )
 {
     int32_t result = 0;
-    int32_t var_term;
-    int64_t intermediate_mul;
     uint8_t coeff_idx;
     
-    for ( coeff_idx = 0;
-          coeff_idx < coeff_len;
-          coeff_idx++ )
+    // Evaluate the polynomial in Horner form, starting from the highest
+    // order coefficient:
+    //
+    //  result = c0 + x * ( c1 + x * ( c2 + ... + x * ( cn ) ) )
+    //
+    // Note: One multiplication is performed per coefficient (after the
+    // first), rather than computing each power term of the variable.
+    //
+    for ( coeff_idx = coeff_len;
+          coeff_idx > 0;
+          coeff_idx-- )
     {
-        // Calculate the variable power value.
-        var_term = UtilPow( var_in, calc_qnum, coeff_idx );
-        
-        // Calculate the polynomial term.
-        // ~ 64-bit multiplication performed.
-        // ~ scale = calc_qnum * coeff_scale
-        intermediate_mul = ((int64_t) var_term) * ((int64_t) coeff[ coeff_idx ]);
-        
-        // Update the result with the polynomial term.
+        // Multiply the accumulated result by the variable, down-scale the
+        // result and add the next polynomial coefficient.
         // ~ scale = coeff_scale
-        result += (int32_t) (intermediate_mul >> calc_qnum);
+        result = UtilMulQ32( result, var_in, calc_qnum ) + coeff[ coeff_idx - 1 ];
     }
     
     return result;
 }
 
-void UtilDelay( uint16_t ms_delay )
+bool UtilPwlInit( UTIL_PWL_S* pwl,
+                  const int16_t x[],
+                  const int32_t y[],
+                  uint8_t len )
 {
-    uint16_t start_time;
-    uint16_t psnt_time;
-    uint16_t p1ms_delay;
+    int64_t slope;
+    uint8_t bp_idx;
     
-    // Scale delay time to resolution of Timer1 (i.e. 1ms -> 0.1ms).
-    p1ms_delay = ms_delay * 10;
+    bool valid = true;
     
-    // Initialize timers for identifying delay time.
-    start_time = TMR2p1msGet();
-    psnt_time  = start_time;
+    // Number of breakpoints is supported ?
+    if( ( len < 2U ) || ( len > UTIL_PWL_LEN_MAX ) )
+    {
+        valid = false;
+    }
     
-    // Wait for the delay time to elapse before exiting the function.
-    //
-    // Note: Condition is 'less than or equal to' to guarantee delay time will
-    // elapse.  For example, with input parameter 'ms_delay' = 5, the time
-    // elapsed will be 5.0-5.1ms.
-    //
-    while ( psnt_time - start_time <= p1ms_delay )
+    for ( bp_idx = 0;
+          ( bp_idx < len ) && ( valid == true );
+          bp_idx++ )
     {
-        psnt_time = TMR2p1msGet();
+        pwl->x[ bp_idx ] = x[ bp_idx ];
+        pwl->y[ bp_idx ] = y[ bp_idx ];
+        
+        // Determine the slope of the segment following the breakpoint.
+        if( bp_idx + 1U < len )
+        {
+            // Breakpoint inputs are strictly increasing ?
+            if( x[ bp_idx + 1U ] > x[ bp_idx ] )
+            {
+                // ~ 64-bit division performed.
+                // ~ scale = Q16
+                slope = ( ( (int64_t) y[ bp_idx + 1U ] - y[ bp_idx ] ) << 16 ) /
+                        ( (int32_t) x[ bp_idx + 1U ] - x[ bp_idx ] );
+                
+                // Slope is within the range of its representation ?
+                //
+                // Note: The interpolated term (slope * input difference) is
+                // then also within the range of the output.
+                //
+                if( ( slope >= INT32_MIN ) && ( slope <= INT32_MAX ) )
+                {
+                    pwl->slope[ bp_idx ] = (int32_t) slope;
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+            else
+            {
+                valid = false;
+            }
+        }
+        else
+        {
+            // Last breakpoint - no following segment.
+            pwl->slope[ bp_idx ] = 0;
+        }
     }
+    
+    pwl->len = ( valid == true ) ? len : 0U;
+    
+    return valid;
 }
 
-// *****************************************************************************
-// ************************** Static Functions *********************************
-// *****************************************************************************
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief  Power term calculation of 32-bit variable.
-///
-/// @param  var_in
-///             The input variable.
-/// @param  calc_qnum
-///             The Q-number (i.e. base-2 radix point) of the input variable.
-/// @param  power
-///             The power (i.e. exponent) of the calculation.
-///
-/// @return The result of the power computation.  Result is scaled by
-///         same value as input 'var_in'.
-////////////////////////////////////////////////////////////////////////////////
-static int32_t UtilPow( int32_t var_in, uint8_t calc_qnum, uint8_t power )
-{    
+int32_t UtilPwl( int16_t var_in, const UTIL_PWL_S* pwl )
+{
+    uint8_t bp_lo;
+    uint8_t bp_hi;
+    uint8_t bp_mid;
     int32_t result;
-    int64_t intermediate_mul;
-    uint8_t pow_idx;
-        
-    // Treat special case of power = 0.
-    if( power == 0 )
+    
+    // Input is below the range of the breakpoints ?
+    if( var_in <= pwl->x[ 0 ] )
     {
-        // Return a value of '1'.
-        result = 1L << calc_qnum;
+        result = pwl->y[ 0 ];
+    }
+    // Input is above the range of the breakpoints ?
+    else if( var_in >= pwl->x[ pwl->len - 1U ] )
+    {
+        result = pwl->y[ pwl->len - 1U ];
     }
-    // power != 0, compute the result by multiplying 'var' by itself for the
-    // number of times equal to 'pow'.
     else
     {
-        // Stored 1st power value.
-        result = var_in;
+        // Binary search for the segment containing the input - i.e.
+        // x[ bp_lo ] <= var_in < x[ bp_hi ].
+        bp_lo = 0;
+        bp_hi = pwl->len - 1U;
         
-        // Calculated 2nd to nth power value.
-        for( pow_idx = 1;
-             pow_idx < power;
-             pow_idx++ )
+        while( bp_hi > bp_lo + 1U )
         {
-            // Perform additional multiplication of input variable.
-            // ~ 64-bit multiplication performed.
-            // ~ scale = 2 * calc_qnum
-            intermediate_mul = ((int64_t) result) * ((int64_t) var_in);
+            bp_mid = ( bp_lo + bp_hi ) >> 1;
             
-            // Down-scale result back to input calculation Q-number.
-            // ~ scale = calc_qnum
-            result = (int32_t) (intermediate_mul >> calc_qnum);
+            if( var_in < pwl->x[ bp_mid ] )
+            {
+                bp_hi = bp_mid;
+            }
+            else
+            {
+                bp_lo = bp_mid;
+            }
         }
+        
+        // Interpolate from the segment's first breakpoint.
+        // ~ scale = Q16 * input LSB
+        result = pwl->y[ bp_lo ] + 
+                 UtilMulQ32( pwl->slope[ bp_lo ], 
+                             (int32_t) var_in - pwl->x[ bp_lo ], 
+                             16U );
     }
     
     return result;
-}
\ No newline at end of file
+}
+
+void UtilDelay( uint16_t ms_delay )
+{
+    uint32_t start_time;
+    uint32_t psnt_time;
+    uint32_t cyc_delay;
+    
+    // Scale delay time to resolution of the instruction cycle counter (i.e.
+    // 1ms -> 20000 instruction cycles).
+    //
+    // Note: The time reference is independent of the software cycle period
+    // (TMR_FRAME_PERIOD_US).
+    cyc_delay = ( (uint32_t) ms_delay ) * ( TMR_CYC_PER_US * 1000U );
+    
+    // Initialize timers for identifying delay time.
+    start_time = TMRTickGet();
+    psnt_time  = start_time;
+    
+    // Wait for the delay time to elapse before exiting the function.
+    //
+    // Note: Unsigned subtraction yields the correct elapsed time through a
+    // roll-over of the counter.
+    //
+    while ( psnt_time - start_time < cyc_delay )
+    {
+        psnt_time = TMRTickGet();
+    }
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
\ No newline at end of file
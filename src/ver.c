@@ -60,29 +60,17 @@ static const VER_SERIAL_NUM_S __attribute__((space(psv))) __at(0x200) serial_num
 
 void VerService ( void )
 {
-    // CAN message transmitted ever 50 software cycles (10ms * 50 = 500ms).
-    static const uint16_t can_tx_period  = 50;
-    static       uint16_t can_tx_timeout = 0;
-    
     CAN_TX_NODE_VER_U version_msg;
     
-    // timeout has elapsed since last CAN message transmission.
-    can_tx_timeout++;
-    if( can_tx_timeout >= can_tx_period )
-    {
-        // reset timeout
-        can_tx_timeout = 0;
-        
-        // Construct the Version CAN message.
-        version_msg.node_type  = node_type;
-        version_msg.rev_ver    = rev_ver;
-        version_msg.min_ver    = min_ver;
-        version_msg.maj_ver    = maj_ver;
-        version_msg.serial_num = serial_num.val;
+    // Construct the Version CAN message.
+    version_msg.node_type  = node_type;
+    version_msg.rev_ver    = rev_ver;
+    version_msg.min_ver    = min_ver;
+    version_msg.maj_ver    = maj_ver;
+    version_msg.serial_num = serial_num.val;
 
-        // Send the Version message.
-        CANTxSet( CAN_TX_MSG_NODE_VER, version_msg.data_u16 );
-    }
+    // Send the Version message.
+    CANTxSet( CAN_TX_MSG_NODE_VER, version_msg.data_u16 );
 }
 
 // *****************************************************************************
@@ -66,6 +66,10 @@
 #define VSENSE2_QNUM_CALC      30U  ///< VSENSE2 polynomial calculation Q-number.
 #define VSENSE2_DIV           100U  ///< VSENSE2 post-calculation division factor.
 
+#if ( VSENSE1_DIV != 100U ) || ( VSENSE2_DIV != 100U )
+#error "Division-free VSENSE output scaling is defined for division by 100 (see UtilDiv100)."
+#endif
+
 // *****************************************************************************
 // ************************** Global Variable Definitions **********************
 // *****************************************************************************
@@ -78,29 +82,29 @@
 // ************************** Function Prototypes ******************************
 // *****************************************************************************
 
+/// VSENSE correction polynomial evaluators (specialized UtilPoly32).
+UTIL_POLY32_DEFINE( Vsense1Poly, VSENSE1_QNUM_CALC, CFG_VSENSE1_COEFF_LEN )
+UTIL_POLY32_DEFINE( Vsense2Poly, VSENSE2_QNUM_CALC, CFG_VSENSE2_COEFF_LEN )
+
 // *****************************************************************************
 // ************************** Global Functions *********************************
 // *****************************************************************************
 
 void VsenseService( void )
 {
-    // CAN message transmitted ever software cycle (10ms).
-    static const uint16_t can_tx_period  = 1;
-    static       uint16_t can_tx_timeout = 0;
-    
-    CAN_TX_VSENSE_DATA_U vsense_msg;
+    CAN_TX_VSENSE_DATA_U* vsense_msg;
     
     uint16_t vsense1_raw;
     int32_t  vsense1_in;
     int32_t  vsense1_cor_i32;
     int16_t  vsense1_cor;
-    int32_t  vsense1_coeff[ CFG_VSENSE1_COEFF_LEN ];
+    const int32_t* vsense1_coeff;
     
     uint16_t vsense2_raw;
     int32_t  vsense2_in;
     int32_t  vsense2_cor_i32;
     int16_t  vsense2_cor;
-    int32_t  vsense2_coeff[ CFG_VSENSE2_COEFF_LEN ];
+    const int32_t* vsense2_coeff;
     
     
     ////////////////////////////////////////////////////////////////////////////
@@ -111,19 +115,16 @@ void VsenseService( void )
     vsense1_raw = ADCGet( ADC_VSENSE1 );
     
     // Get vsense polynomial coefficient correction values.
-    CfgVsense1CoeffGet( &vsense1_coeff[ 0 ] );
+    vsense1_coeff = CfgVsense1CoeffGet();
     
     // Scale VSENSE1 by the calculation factor.
     vsense1_in = ((int32_t) vsense1_raw) << ( VSENSE1_QNUM_CALC - VSENSE1_QNUM_RAW );
     
     // Perform correction of VSENSE1 value
-    vsense1_cor_i32 = UtilPoly32( vsense1_in,
-                                  VSENSE1_QNUM_CALC,
-                                  &vsense1_coeff[ 0 ], 
-                                  CFG_VSENSE1_COEFF_LEN );
+    vsense1_cor_i32 = Vsense1Poly( vsense1_in, vsense1_coeff );
 
     // Down-scale the VSENSE1 result to the correction factors Q-number.
-    vsense1_cor = (int16_t) ( vsense1_cor_i32 / VSENSE1_DIV );
+    vsense1_cor = (int16_t) UtilDiv100( vsense1_cor_i32 );
     
     
     ////////////////////////////////////////////////////////////////////////////
@@ -134,40 +135,35 @@ void VsenseService( void )
     vsense2_raw = ADCGet( ADC_VSENSE2 );
     
     // Get vsense polynomial coefficient correction values.
-    CfgVsense2CoeffGet( &vsense2_coeff[ 0 ] );
+    vsense2_coeff = CfgVsense2CoeffGet();
     
     // Scale VSENSE12 by the calculation factor.
     vsense2_in = ((int32_t) vsense2_raw) << ( VSENSE2_QNUM_CALC - VSENSE2_QNUM_RAW );
     
     // Perform correction of VSENSE2 value
-    vsense2_cor_i32 = UtilPoly32( vsense2_in,
-                                  VSENSE2_QNUM_CALC,
-                                  &vsense2_coeff[ 0 ], 
-                                  CFG_VSENSE2_COEFF_LEN );
+    vsense2_cor_i32 = Vsense2Poly( vsense2_in, vsense2_coeff );
 
     // Down-scale the VSENSE2 result to the correction factors Q-number.
-    vsense2_cor = (int16_t) ( vsense2_cor_i32 / VSENSE2_DIV );
+    vsense2_cor = (int16_t) UtilDiv100( vsense2_cor_i32 );
     
     
     ////////////////////////////////////////////////////////////////////////////
     // VSENSE Annunciation
     ////////////////////////////////////////////////////////////////////////////
     
-    // timeout has elapsed since last CAN message transmission.
-    can_tx_timeout++;
-    if( can_tx_timeout >= can_tx_period )
+    // Construct the vsense CAN message in place within the transmit queue.
+    vsense_msg = (CAN_TX_VSENSE_DATA_U*) CANTxAcquire( CAN_TX_MSG_VSENSE_DATA );
+    
+    // Transmit queue is not full ?
+    if( vsense_msg != NULL )
     {
-        // reset timeout
-        can_tx_timeout = 0;
+        vsense_msg->vsense1_raw = vsense1_raw;
+        vsense_msg->vsense1_cor = vsense1_cor;
+        vsense_msg->vsense2_raw = vsense2_raw;
+        vsense_msg->vsense2_cor = vsense2_cor;
         
-        // Construct the vsense CAN message.
-        vsense_msg.vsense1_raw = vsense1_raw;
-        vsense_msg.vsense1_cor = vsense1_cor;
-        vsense_msg.vsense2_raw = vsense2_raw;
-        vsense_msg.vsense2_cor = vsense2_cor;
-
         // Send the CAN message.
-        CANTxSet( CAN_TX_MSG_VSENSE_DATA, vsense_msg.data_u16 );
+        CANTxCommit( CAN_TX_MSG_VSENSE_DATA );
     }
 }
 
@@ -0,0 +1,511 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host calibration math sweep tool.
+///
+/// The firmware's fixed-point calibration path is executed on the host over
+/// the full input domain, using the coefficient set supplied on the command
+/// line, and compared to a double-precision evaluation of the polynomial:
+///
+///     servo   - every int16 position command (LSB = 0.001rad), through the
+///               servo module's position correction and Servo Command
+///               processing (applied PWM, LSB = 1us).
+///     vsense  - every 12-bit ADC count, through the VSENSE module's
+///               correction (corrected value, LSB = 0.01).
+///
+/// The maximum and mean error, overflow of the Horner intermediates and the
+/// output representation, and the execution time and throughput of each
+/// evaluator over the full input domain of the channel are reported, so that
+/// a coefficient set can be vetted before it is written over CAN.
+///
+/// Build (from this directory - see Makefile):
+///
+///     make
+///
+/// Usage:
+///
+///     build/calsweep servo|vsense c0 [c1 ... c5]
+///
+/// The exit status is 1 if overflow occurs within the valid input range.
+///
+/// @note   The firmware modules are compiled into the tool (with stubs of
+///         the hardware and CAN interfaces), so that the evaluated path is
+///         that of the firmware.  The portable multiplication kernel is
+///         used (see UTIL_MUL16_ENABLE); the hardware kernel produces
+///         identical results.  Execution times are those of the host - see
+///         the bench module for execution times on the target.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "servo.c"
+#include "vsense.c"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define SWEEP_COEFF_LEN     6U          ///< Number of coefficients of a set.
+#define SWEEP_TIME_REPS     200U        ///< Repetitions of each timed sweep.
+#define SWEEP_REPORT_MAX    5U          ///< Number of overflow cases listed.
+
+/// Error statistics of a sweep.
+typedef struct
+{
+    double   err_max;       ///< Maximum absolute error (LSB = output LSB).
+    double   err_sum;       ///< Accumulated absolute error.
+    uint32_t cnt;           ///< Number of evaluated inputs.
+    uint32_t ovf_mid_cnt;   ///< Inputs for which a Horner intermediate exceeds int32.
+    uint32_t ovf_out_cnt;   ///< Inputs for which the output exceeds its representation.
+
+} SWEEP_STAT_S;
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Coefficient set under evaluation (all channels).
+static int32_t sweep_coeff[ SWEEP_COEFF_LEN ];
+
+/// Servo Command payload returned by the CAN receive stub.
+static CAN_RX_SERVO_CMD_U sweep_rx_cmd;
+
+/// Servo Command is pending for the CAN receive stub.
+static bool sweep_rx_pending = false;
+
+/// PWM duty cycle applied through the PWM stub (LSB = 1us).
+static uint16_t sweep_pwm_duty;
+
+/// ADC count returned by the ADC stub.
+static uint16_t sweep_adc_cnt;
+
+/// VSENSE Data payload sent through the CAN transmit stub.
+static CAN_TX_VSENSE_DATA_U sweep_vsense_msg;
+
+/// Sink of timed evaluations, so that they are not optimized away.
+static volatile int32_t sweep_sink;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+static double SweepRefHorner( double var_in, uint32_t* ovf_mid );
+static void SweepStatUpdate( SWEEP_STAT_S* stat, double err );
+static void SweepStatPrint( const char* name, const SWEEP_STAT_S* stat );
+static double SweepTimeNs( int32_t (*eval)( int32_t var_sel ), uint32_t sel_len );
+static void SweepTimePrint( const char* name, int32_t (*eval)( int32_t var_sel ), uint32_t sel_len );
+static int32_t SweepServoVarIn( int32_t var_sel );
+static int32_t SweepServoGeneric( int32_t var_sel );
+static int32_t SweepServoSpec( int32_t var_sel );
+static int32_t SweepServoCorrect( int32_t var_sel );
+static int32_t SweepVsenseGeneric( int32_t var_sel );
+static int32_t SweepVsenseSpec( int32_t var_sel );
+static int SweepServo( void );
+static int SweepVsense( void );
+
+// *****************************************************************************
+// ************************** Firmware Interface Stubs *************************
+// *****************************************************************************
+
+bool CANRxGet ( CAN_RX_MSG_TYPE_E rx_msg_type, uint16_t payload[ 4 ] )
+{
+    bool payload_valid = false;
+
+    if( ( rx_msg_type == CAN_RX_MSG_SERVO_CMD ) && ( sweep_rx_pending == true ) )
+    {
+        memcpy( payload, sweep_rx_cmd.data_u16, sizeof( sweep_rx_cmd.data_u16 ) );
+        sweep_rx_pending = false;
+        payload_valid    = true;
+    }
+
+    return payload_valid;
+}
+
+uint32_t CANRxTickGet ( CAN_RX_MSG_TYPE_E rx_msg_type )
+{
+    (void) rx_msg_type;
+    return 0;
+}
+
+uint16_t* CANTxAcquire ( CAN_TX_MSG_TYPE_E tx_msg_type )
+{
+    // Note: Messages other than VSENSE Data are built in a discarded entry.
+    static uint16_t sweep_tx_discard[ 4 ];
+
+    uint16_t* tx_payload = sweep_tx_discard;
+
+    if( tx_msg_type == CAN_TX_MSG_VSENSE_DATA )
+    {
+        tx_payload = sweep_vsense_msg.data_u16;
+    }
+
+    return tx_payload;
+}
+
+void CANTxCommit ( CAN_TX_MSG_TYPE_E tx_msg_type )
+{
+    (void) tx_msg_type;
+}
+
+uint16_t CfgGenGet ( void )                     { return 1; }
+const int32_t* CfgPWMCoeffGet ( void )          { return sweep_coeff; }
+const int32_t* CfgVsense1CoeffGet ( void )      { return sweep_coeff; }
+const int32_t* CfgVsense2CoeffGet ( void )      { return sweep_coeff; }
+CFG_CAL_E CfgPWMCalTypeGet ( void )             { return CFG_CAL_POLY; }
+const UTIL_PWL_S* CfgPWMPwlGet ( void )         { return NULL; }
+uint16_t INA219VoltGet ( void )                 { return 0; }
+uint16_t INA219AmpGet ( void )                  { return 0; }
+uint16_t ADCGet ( ADC_AIN_E adc_sel )           { (void) adc_sel; return sweep_adc_cnt; }
+void PWMDutySet ( uint16_t pwm_duty )           { sweep_pwm_duty = pwm_duty; }
+uint32_t TMRTickGet ( void )                    { return 0; }
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+int main( int argc, char* argv[] )
+{
+    int      status = 2;
+    uint8_t  coeff_idx;
+
+    if( ( argc >= 3 ) && ( argc <= 2 + (int) SWEEP_COEFF_LEN ) )
+    {
+        for( coeff_idx = 0;
+             coeff_idx < SWEEP_COEFF_LEN;
+             coeff_idx++ )
+        {
+            sweep_coeff[ coeff_idx ] = ( coeff_idx + 2 < argc ) ?
+                                            (int32_t) strtol( argv[ coeff_idx + 2 ], NULL, 0 ) : 0;
+        }
+
+        if( strcmp( argv[ 1 ], "servo" ) == 0 )
+        {
+            status = SweepServo();
+        }
+        else if( strcmp( argv[ 1 ], "vsense" ) == 0 )
+        {
+            status = SweepVsense();
+        }
+    }
+
+    if( status == 2 )
+    {
+        fprintf( stderr, "usage: %s servo|vsense c0 [c1 ... c5]\n", argv[ 0 ] );
+    }
+
+    return status;
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Double-precision Horner evaluation of the coefficient set.
+///
+/// @param  var_in
+///             The input variable (unscaled - e.g. radians).
+/// @param  ovf_mid
+///             Incremented if an intermediate (in coefficient units) exceeds
+///             the range of int32 - i.e. the firmware's intermediate
+///             overflows.
+///
+/// @return The polynomial value (in coefficient units).
+////////////////////////////////////////////////////////////////////////////////
+static double SweepRefHorner( double var_in, uint32_t* ovf_mid )
+{
+    double  result = 0.0;
+    bool    ovf    = false;
+    uint8_t coeff_idx;
+
+    for( coeff_idx = SWEEP_COEFF_LEN;
+         coeff_idx > 0;
+         coeff_idx-- )
+    {
+        result = ( result * var_in ) + sweep_coeff[ coeff_idx - 1 ];
+
+        if( ( result > INT32_MAX ) || ( result < INT32_MIN ) )
+        {
+            ovf = true;
+        }
+    }
+
+    if( ovf == true )
+    {
+        ( *ovf_mid )++;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Accumulate an error measurement.
+////////////////////////////////////////////////////////////////////////////////
+static void SweepStatUpdate( SWEEP_STAT_S* stat, double err )
+{
+    err = fabs( err );
+
+    if( err > stat->err_max )
+    {
+        stat->err_max = err;
+    }
+
+    stat->err_sum += err;
+    stat->cnt++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Print the error statistics of a sweep.
+////////////////////////////////////////////////////////////////////////////////
+static void SweepStatPrint( const char* name, const SWEEP_STAT_S* stat )
+{
+    printf( "  %-28s max %10.3f  mean %10.3f  (%u inputs)\n",
+            name,
+            stat->err_max,
+            ( stat->cnt != 0 ) ? stat->err_sum / stat->cnt : 0.0,
+            (unsigned) stat->cnt );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Measure the mean host execution time of an evaluator.
+///
+/// @param  eval
+///             The evaluator, executed for each input selection.
+/// @param  sel_len
+///             Number of input selections.
+///
+/// @return Mean execution time per evaluation (ns).
+////////////////////////////////////////////////////////////////////////////////
+static double SweepTimeNs( int32_t (*eval)( int32_t var_sel ), uint32_t sel_len )
+{
+    struct timespec start_time;
+    struct timespec end_time;
+    uint32_t rep_idx;
+    uint32_t sel_idx;
+
+    clock_gettime( CLOCK_MONOTONIC, &start_time );
+
+    for( rep_idx = 0; rep_idx < SWEEP_TIME_REPS; rep_idx++ )
+    {
+        for( sel_idx = 0; sel_idx < sel_len; sel_idx++ )
+        {
+            sweep_sink = eval( (int32_t) sel_idx );
+        }
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &end_time );
+
+    return ( ( end_time.tv_sec  - start_time.tv_sec  ) * 1e9 +
+             ( end_time.tv_nsec - start_time.tv_nsec ) ) /
+           ( (double) SWEEP_TIME_REPS * sel_len );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Report the mean host execution time and the throughput of an
+///         evaluator.
+////////////////////////////////////////////////////////////////////////////////
+static void SweepTimePrint( const char* name, int32_t (*eval)( int32_t var_sel ), uint32_t sel_len )
+{
+    double time_ns = SweepTimeNs( eval, sel_len );
+
+    printf( "  %-28s %8.1f ns  %8.2f M evaluations/s\n", name, time_ns, 1e3 / time_ns );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the Q30 servo input of a position command selection (the
+///         position command offset from INT16_MIN, 0 - 65535), as scaled by
+///         the servo module - i.e. with commands outside of +/-1.024rad
+///         wrapped to the range (see ServoPosCorrect).
+////////////////////////////////////////////////////////////////////////////////
+static int32_t SweepServoVarIn( int32_t var_sel )
+{
+    int32_t pos_wrap = ( ( var_sel + 1024 ) & 0x7FF ) - 1024;
+
+    return ( ( pos_wrap * ( 1L << 21 ) ) / 1000 ) * ( 1L << 9 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Timed servo evaluators - input selection is the position command
+///         offset from INT16_MIN (0 - 65535).
+////////////////////////////////////////////////////////////////////////////////
+static int32_t SweepServoGeneric( int32_t var_sel )
+{
+    return UtilPoly32( SweepServoVarIn( var_sel ),
+                       SERVO_QNUM_CALC, sweep_coeff, CFG_PWM_COEFF_LEN );
+}
+
+static int32_t SweepServoSpec( int32_t var_sel )
+{
+    return ServoPoly( SweepServoVarIn( var_sel ), sweep_coeff );
+}
+
+static int32_t SweepServoCorrect( int32_t var_sel )
+{
+    return ServoPosCorrect( (int16_t) ( var_sel + INT16_MIN ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Timed VSENSE evaluators - input selection is the ADC count.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t SweepVsenseGeneric( int32_t var_sel )
+{
+    return UtilPoly32( var_sel << ( VSENSE1_QNUM_CALC - VSENSE1_QNUM_RAW ),
+                       VSENSE1_QNUM_CALC, sweep_coeff, CFG_VSENSE1_COEFF_LEN );
+}
+
+static int32_t SweepVsenseSpec( int32_t var_sel )
+{
+    return Vsense1Poly( var_sel << ( VSENSE1_QNUM_CALC - VSENSE1_QNUM_RAW ), sweep_coeff );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Sweep the servo position correction.
+///
+/// @return Exit status (1 - overflow within the valid position range).
+////////////////////////////////////////////////////////////////////////////////
+static int SweepServo( void )
+{
+    SWEEP_STAT_S stat_cor   = { 0 };
+    SWEEP_STAT_S stat_pwm   = { 0 };
+    uint32_t     wrap_cnt   = 0;
+    uint32_t     report_cnt = 0;
+    uint32_t     ovf_mid;
+
+    int32_t  cmd_pos;
+    double   ref_cor;
+    double   ref_pwm;
+    int32_t  fw_cor;
+    bool     pos_valid;
+
+    printf( "Servo position correction (coefficients %ld %ld %ld %ld %ld %ld)\n",
+            (long) sweep_coeff[ 0 ], (long) sweep_coeff[ 1 ], (long) sweep_coeff[ 2 ],
+            (long) sweep_coeff[ 3 ], (long) sweep_coeff[ 4 ], (long) sweep_coeff[ 5 ] );
+
+    for( cmd_pos = INT16_MIN; cmd_pos <= INT16_MAX; cmd_pos++ )
+    {
+        // Position command is within the range of the Q30 input scaling ?
+        pos_valid = ( cmd_pos >= -1024 ) && ( cmd_pos <= 1023 );
+
+        // Firmware correction output (LSB = 0.01us).
+        fw_cor = ServoPosCorrect( (int16_t) cmd_pos );
+
+        // Firmware applied PWM, by processing of a Servo Command.
+        sweep_rx_cmd.cmd_type = SERVO_CTRL_POS;
+        sweep_rx_cmd.cmd_pwm  = 0;
+        sweep_rx_cmd.cmd_pos  = (int16_t) cmd_pos;
+        sweep_rx_pending      = true;
+        ServoService();
+
+        ovf_mid = 0;
+        ref_cor = SweepRefHorner( cmd_pos / 1000.0, &ovf_mid );
+        ref_pwm = trunc( ref_cor / 100.0 );
+
+        if( pos_valid == true )
+        {
+            SweepStatUpdate( &stat_cor, (double) fw_cor - ref_cor );
+            SweepStatUpdate( &stat_pwm, (double) sweep_pwm_duty - ref_pwm );
+
+            stat_pwm.ovf_mid_cnt += ovf_mid;
+
+            if( ( ref_pwm < 0.0 ) || ( ref_pwm > UINT16_MAX ) )
+            {
+                stat_pwm.ovf_out_cnt++;
+            }
+
+            if( ( ( ovf_mid != 0 ) || ( ref_pwm < 0.0 ) || ( ref_pwm > UINT16_MAX ) ) &&
+                ( report_cnt < SWEEP_REPORT_MAX ) )
+            {
+                printf( "  overflow: pos %6ld  reference PWM %12.2fus  applied %5u\n",
+                        (long) cmd_pos, ref_cor / 100.0, (unsigned) sweep_pwm_duty );
+                report_cnt++;
+            }
+        }
+        else if( fabs( (double) sweep_pwm_duty - ref_pwm ) >= 1.0 )
+        {
+            wrap_cnt++;
+        }
+    }
+
+    printf( "Error within +/-1.024rad:\n" );
+    SweepStatPrint( "correction (LSB = 0.01us)", &stat_cor );
+    SweepStatPrint( "applied PWM (LSB = 1us)", &stat_pwm );
+    printf( "Overflow within +/-1.024rad: intermediate %u, PWM output %u\n",
+            (unsigned) stat_pwm.ovf_mid_cnt, (unsigned) stat_pwm.ovf_out_cnt );
+    printf( "Positions outside +/-1.024rad with PWM error >= 1us (input wraps): %u\n",
+            (unsigned) wrap_cnt );
+
+    printf( "Host execution time per evaluation (every int16 position command):\n" );
+    SweepTimePrint( "UtilPoly32",               SweepServoGeneric, 65536UL );
+    SweepTimePrint( "ServoPoly (specialized)",  SweepServoSpec,    65536UL );
+    SweepTimePrint( "ServoPosCorrect (scaled)", SweepServoCorrect, 65536UL );
+
+    return ( ( stat_pwm.ovf_mid_cnt != 0 ) || ( stat_pwm.ovf_out_cnt != 0 ) ) ? 1 : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Sweep the VSENSE correction.
+///
+/// @return Exit status (1 - overflow within the ADC range).
+////////////////////////////////////////////////////////////////////////////////
+static int SweepVsense( void )
+{
+    SWEEP_STAT_S stat_cor   = { 0 };
+    uint32_t     report_cnt = 0;
+    uint32_t     ovf_mid;
+
+    uint16_t adc_cnt;
+    double   ref_cor;
+
+    printf( "VSENSE correction (coefficients %ld %ld %ld %ld %ld %ld)\n",
+            (long) sweep_coeff[ 0 ], (long) sweep_coeff[ 1 ], (long) sweep_coeff[ 2 ],
+            (long) sweep_coeff[ 3 ], (long) sweep_coeff[ 4 ], (long) sweep_coeff[ 5 ] );
+
+    for( adc_cnt = 0; adc_cnt < ( 1U << VSENSE1_QNUM_RAW ); adc_cnt++ )
+    {
+        // Firmware corrected value (LSB = 0.01).
+        sweep_adc_cnt = adc_cnt;
+        VsenseService();
+
+        ovf_mid = 0;
+        ref_cor = trunc( SweepRefHorner( adc_cnt / (double) ( 1U << VSENSE1_QNUM_RAW ), &ovf_mid ) / 100.0 );
+
+        SweepStatUpdate( &stat_cor, (double) sweep_vsense_msg.vsense1_cor - ref_cor );
+
+        stat_cor.ovf_mid_cnt += ovf_mid;
+
+        if( ( ref_cor < INT16_MIN ) || ( ref_cor > INT16_MAX ) )
+        {
+            stat_cor.ovf_out_cnt++;
+        }
+
+        if( ( ( ovf_mid != 0 ) || ( ref_cor < INT16_MIN ) || ( ref_cor > INT16_MAX ) ) &&
+            ( report_cnt < SWEEP_REPORT_MAX ) )
+        {
+            printf( "  overflow: count %4u  reference %12.2f  corrected %6d\n",
+                    (unsigned) adc_cnt, ref_cor, (int) sweep_vsense_msg.vsense1_cor );
+            report_cnt++;
+        }
+    }
+
+    printf( "Error over the 12-bit ADC range:\n" );
+    SweepStatPrint( "corrected value (LSB = 0.01)", &stat_cor );
+    printf( "Overflow: intermediate %u, output %u\n",
+            (unsigned) stat_cor.ovf_mid_cnt, (unsigned) stat_cor.ovf_out_cnt );
+
+    printf( "Host execution time per evaluation (every 12-bit ADC count):\n" );
+    SweepTimePrint( "UtilPoly32",                SweepVsenseGeneric, 1UL << VSENSE1_QNUM_RAW );
+    SweepTimePrint( "Vsense1Poly (specialized)", SweepVsenseSpec,    1UL << VSENSE1_QNUM_RAW );
+
+    return ( ( stat_cor.ovf_mid_cnt != 0 ) || ( stat_cor.ovf_out_cnt != 0 ) ) ? 1 : 0;
+}
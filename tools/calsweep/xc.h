@@ -0,0 +1,7 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host build substitute of the XC16 device header.
+///
+/// The firmware headers included by the sweep tool do not use device
+/// registers, so no definitions are required.
+////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -0,0 +1,1036 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host simulation of the firmware - hardware model.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#define HOSTSIM_SFR_DEFINE
+#include <xc.h>
+
+#include <setjmp.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "hostsim.h"
+
+#include "adc.h"
+#include "can.h"
+#include "cfg.h"
+#include "dio.h"
+#include "i2c.h"
+#include "ina219.h"
+#include "nvm.h"
+#include "osc.h"
+#include "pwm.h"
+#include "rst.h"
+#include "sch.h"
+#include "tmr.h"
+#include "wdt.h"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+/// Minimum watchdog timeout (~27ms - see the FWDT configuration of main.c).
+#define HOSTSIM_WDT_CYC         ( 27000UL * HOSTSIM_CYC_PER_US )
+
+/// Maximum number of interrupts executed at one time - exceeded if an
+/// interrupt does not clear its flag.
+#define HOSTSIM_ISR_BURST_MAX   1000U
+
+/// Number of analog inputs.
+#define HOSTSIM_AIN_NUM_OF      32U
+
+/// Number of ECAN acceptance filters modeled.
+#define HOSTSIM_CAN_FLT_NUM_OF  6U
+
+/// Number of ECAN transmit buffers.
+#define HOSTSIM_CAN_TX_NUM_OF   8U
+
+/// Number of INA219 registers.
+#define HOSTSIM_INA219_REG_NUM_OF   6U
+
+#define HOSTSIM_INA219_SADDR    0x40U   ///< INA219 slave address.
+#define HOSTSIM_INA219_BUS_VOLT 0x02U   ///< INA219 Bus Voltage register address.
+#define HOSTSIM_INA219_CURRENT  0x04U   ///< INA219 Current register address.
+
+#define HOSTSIM_NVM_PAGE_BYTES  1024U   ///< Host size of an NVM page (512 words).
+
+/// 16-bit timer (Timer1 and Timer4) state.
+typedef struct
+{
+    volatile uint16_t* con;     ///< Control register (TON bit 15, TCKPS bits 5-4).
+    volatile uint16_t* tmr;     ///< Timer value register.
+    volatile uint16_t* pr;      ///< Period register.
+    volatile uint16_t* ifs;     ///< Interrupt flag register.
+    uint16_t if_mask;           ///< Interrupt flag bit.
+    uint64_t cyc_last;          ///< Time of the last update.
+    uint32_t presc_acc;         ///< Cycles accumulated toward the next prescaled count.
+
+} HOSTSIM_TMR_S;
+
+/// Interrupt control of each interrupt.
+typedef struct
+{
+    void (*isr)( void );        ///< Interrupt service routine.
+    volatile uint16_t* ifs;     ///< Interrupt flag register.
+    volatile uint16_t* iec;     ///< Interrupt enable register.
+    uint16_t mask;              ///< Interrupt flag/enable bit.
+
+} HOSTSIM_ISR_S;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+// Interrupt service routines of main.c.
+void _T1Interrupt ( void );
+void _T3Interrupt ( void );
+void _T4Interrupt ( void );
+void _C1Interrupt ( void );
+
+static void     HostsimUpdate ( void );
+static void     HostsimStop ( HOSTSIM_STOP_E stop ) __attribute__(( noreturn ));
+static uint16_t HostsimIplGet ( HOSTSIM_ISR_E isr );
+static void     HostsimIsrDispatch ( void );
+static uint64_t HostsimEventNext ( uint64_t cyc_end );
+static void     HostsimTmrUpdate ( HOSTSIM_TMR_S* tmr );
+static uint64_t HostsimTmrEventNext ( const HOSTSIM_TMR_S* tmr );
+static void     HostsimTmr23Update ( void );
+static void     HostsimCanIntSet ( uint16_t intf_mask );
+static void     HostsimCanTxUpdate ( void );
+static bool     HostsimCanFltMatch ( uint8_t flt_idx, const HOSTSIM_CAN_FRAME_S* frame );
+static void     HostsimCanStore ( uint8_t buf_idx, uint8_t flt_idx, const HOSTSIM_CAN_FRAME_S* frame );
+static volatile uint16_t (*HostsimCanBufGet ( void ))[ 8 ];
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Simulation time (LSB = 1 instruction cycle).
+static uint64_t hostsim_cyc;
+
+/// Condition which stopped the simulation.
+static HOSTSIM_STOP_E hostsim_stop = HOSTSIM_STOP_NONE;
+
+/// Return point of a stop of the simulation.
+static jmp_buf hostsim_stop_jmp;
+
+/// Observation of the simulation.
+static HOSTSIM_HOOK_S hostsim_hook;
+
+/// Last reported PWM duty cycle register value.
+static uint16_t hostsim_pdc_last;
+
+/// Time of the last watchdog clear.
+static uint64_t hostsim_wdt_cyc;
+
+/// Operation counts of the firmware execution.
+static HOSTSIM_OP_CNT_S hostsim_op_cnt;
+
+/// Timer1 (software cycle) and Timer4 (one-shot).
+static HOSTSIM_TMR_S hostsim_tmr1 =
+{
+    &hostsim_T1CON.reg, &hostsim_TMR1, &hostsim_PR1, &hostsim_IFS0.reg, 0x0008, 0, 0
+};
+static HOSTSIM_TMR_S hostsim_tmr4 =
+{
+    &hostsim_T4CON.reg, &hostsim_TMR4, &hostsim_PR4, &hostsim_IFS1.reg, 0x0800, 0, 0
+};
+
+/// Timer2/3 (32-bit instruction cycle counter) start time and roll-overs.
+static bool     hostsim_tmr23_on;
+static uint64_t hostsim_tmr23_base;
+static uint64_t hostsim_tmr23_roll;
+
+/// Interrupts held pending (see HostsimIsrHold).
+static bool hostsim_isr_hold[ HOSTSIM_ISR_NUM_OF ];
+
+/// Interrupts, in natural order (i.e. order of execution at equal priority).
+static const HOSTSIM_ISR_S hostsim_isr[ HOSTSIM_ISR_NUM_OF ] =
+{
+    { _T1Interrupt, &hostsim_IFS0.reg, &hostsim_IEC0.reg, 0x0008 },
+    { _T3Interrupt, &hostsim_IFS0.reg, &hostsim_IEC0.reg, 0x0100 },
+    { _T4Interrupt, &hostsim_IFS1.reg, &hostsim_IEC1.reg, 0x0800 },
+    { _C1Interrupt, &hostsim_IFS2.reg, &hostsim_IEC2.reg, 0x0008 },
+};
+
+/// Analog input values.
+static uint16_t hostsim_ain[ HOSTSIM_AIN_NUM_OF ];
+
+/// Bit rate (baud rate prescaler) of the bus traffic.
+static uint8_t hostsim_can_brp;
+
+/// Receive FIFO frames written and read (free-running counters).
+static uint32_t hostsim_can_fifo_wr;
+static uint32_t hostsim_can_fifo_rd;
+
+/// Transmission in progress (buffer index, or HOSTSIM_CAN_TX_NUM_OF if the
+/// bus is idle) and its completion time.
+static uint8_t  hostsim_can_tx_buf = HOSTSIM_CAN_TX_NUM_OF;
+static uint64_t hostsim_can_tx_end;
+static HOSTSIM_CAN_FRAME_S hostsim_can_tx_frame;
+
+/// Acceptance filter registers.
+static volatile HOSTSIM_C1RXF0SID_U* const hostsim_can_flt_sid[ HOSTSIM_CAN_FLT_NUM_OF ] =
+{
+    (volatile HOSTSIM_C1RXF0SID_U*) &hostsim_C1RXF0SID,
+    (volatile HOSTSIM_C1RXF0SID_U*) &hostsim_C1RXF1SID,
+    (volatile HOSTSIM_C1RXF0SID_U*) &hostsim_C1RXF2SID,
+    (volatile HOSTSIM_C1RXF0SID_U*) &hostsim_C1RXF3SID,
+    (volatile HOSTSIM_C1RXF0SID_U*) &hostsim_C1RXF4SID,
+    (volatile HOSTSIM_C1RXF0SID_U*) &hostsim_C1RXF5SID,
+};
+static volatile uint16_t* const hostsim_can_flt_eid[ HOSTSIM_CAN_FLT_NUM_OF ] =
+{
+    &hostsim_C1RXF0EID, &hostsim_C1RXF1EID, &hostsim_C1RXF2EID,
+    &hostsim_C1RXF3EID, &hostsim_C1RXF4EID, &hostsim_C1RXF5EID,
+};
+
+/// Transmit buffer control registers (two buffers per register).
+static volatile uint16_t* const hostsim_can_trcon[ HOSTSIM_CAN_TX_NUM_OF / 2 ] =
+{
+    &hostsim_C1TR01CON.reg, &hostsim_C1TR23CON.reg,
+    &hostsim_C1TR45CON.reg, &hostsim_C1TR67CON.reg,
+};
+
+/// INA219 registers and register pointer.
+static uint16_t hostsim_ina219_reg[ HOSTSIM_INA219_REG_NUM_OF ];
+static uint8_t  hostsim_ina219_ptr;
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+bool HostsimStart ( const HOSTSIM_HOOK_S* hook )
+{
+    if( hook != NULL )
+    {
+        hostsim_hook = *hook;
+    }
+
+    // Reset state of the registers which differ from zero.
+    hostsim_RCON.bits.POR          = 1;     // Power-on reset.
+    hostsim_RCON.bits.BOR          = 1;
+    hostsim_OSCCON.bits.LOCK       = 1;     // PLL is locked on request.
+    hostsim_C1CTRL1.bits.REQOP     = 4;     // Configuration Mode.
+    hostsim_C1CTRL1.bits.OPMODE    = 4;
+    hostsim_PR1                    = 0xFFFF;
+    hostsim_PR2                    = 0xFFFF;
+    hostsim_PR3                    = 0xFFFF;
+    hostsim_PR4                    = 0xFFFF;
+
+    if( setjmp( hostsim_stop_jmp ) == 0 )
+    {
+        // Start-up sequence of main().
+        WDTEnable();
+        CfgInit();
+
+        OSCInit();
+        TMRInit();
+        DIOInit();
+        ADCInit();
+        PWMInit();
+        CANInit();
+        NVMInit();
+        I2CInit();
+
+        INA219Init();
+
+        RSTStartup();
+
+        INTCON2bits.GIE = 1;
+
+        SchInit();
+
+        TMR1Enable();
+        PWMEnable();
+
+        HostsimUpdate();
+
+        hostsim_pdc_last = hostsim_PDC3;
+        if( hostsim_hook.pwm != NULL )
+        {
+            hostsim_hook.pwm( hostsim_PDC3 );
+        }
+    }
+
+    return ( hostsim_stop == HOSTSIM_STOP_NONE );
+}
+
+bool HostsimRun ( uint64_t cyc_end )
+{
+    if( ( hostsim_stop  == HOSTSIM_STOP_NONE ) &&
+        ( setjmp( hostsim_stop_jmp ) == 0    ) )
+    {
+        HostsimUpdate();
+        HostsimIsrDispatch();
+
+        while( hostsim_cyc < cyc_end )
+        {
+            hostsim_cyc = HostsimEventNext( cyc_end );
+
+            HostsimUpdate();
+            HostsimIsrDispatch();
+        }
+    }
+
+    return ( hostsim_stop == HOSTSIM_STOP_NONE );
+}
+
+uint64_t HostsimCycGet ( void )
+{
+    return hostsim_cyc;
+}
+
+HOSTSIM_STOP_E HostsimStopGet ( void )
+{
+    return hostsim_stop;
+}
+
+void HostsimOpCntGet ( HOSTSIM_OP_CNT_S* op_cnt )
+{
+    *op_cnt = hostsim_op_cnt;
+}
+
+void HostsimIsrHold ( HOSTSIM_ISR_E isr, bool hold )
+{
+    hostsim_isr_hold[ isr ] = hold;
+}
+
+void HostsimCanRx ( const HOSTSIM_CAN_FRAME_S* frame )
+{
+    uint8_t  flt_idx;
+    uint8_t  bp;
+    uint8_t  buf_idx;
+    uint8_t  fifo_start;
+    uint8_t  fifo_len;
+    uint8_t  fifo_cnt;
+    int      ovf_buf = -1;
+    bool     stored  = false;
+
+    // Received only in Normal or Listen Only Mode at the bit rate of the bus.
+    if( ( ( hostsim_C1CTRL1.bits.OPMODE == 0 ) ||
+          ( hostsim_C1CTRL1.bits.OPMODE == 3 ) ) &&
+        ( hostsim_C1CFG1.bits.BRP == hostsim_can_brp ) )
+    {
+        fifo_start = hostsim_C1FCTRL.bits.FSA;
+        fifo_len   = 16U - fifo_start;
+
+        // Store the frame by the first matching filter with a free buffer.
+        for( flt_idx = 0;
+             ( flt_idx < HOSTSIM_CAN_FLT_NUM_OF ) && ( stored == false );
+             flt_idx++ )
+        {
+            if( HostsimCanFltMatch( flt_idx, frame ) == true )
+            {
+                bp = ( flt_idx < 4U ) ? ( ( hostsim_C1BUFPNT1.reg >> ( flt_idx * 4U ) ) & 0xFU ) :
+                                        ( ( hostsim_C1BUFPNT2.reg >> ( ( flt_idx - 4U ) * 4U ) ) & 0xFU );
+
+                buf_idx = ( bp == 0xFU ) ? (uint8_t) ( fifo_start + ( hostsim_can_fifo_wr % fifo_len ) ) : bp;
+
+                if( ( hostsim_C1RXFUL1 & ( 1U << buf_idx ) ) == 0 )
+                {
+                    HostsimCanStore( buf_idx, flt_idx, frame );
+                    stored = true;
+
+                    if( bp == 0xFU )
+                    {
+                        hostsim_can_fifo_wr++;
+
+                        // FIFO almost full (i.e. a single free buffer remains) ?
+                        fifo_cnt = (uint8_t) ( hostsim_can_fifo_wr - hostsim_can_fifo_rd );
+                        if( fifo_cnt == fifo_len - 1U )
+                        {
+                            HostsimCanIntSet( 0x0008 );
+                        }
+                    }
+
+                    HostsimCanIntSet( 0x0002 );
+                }
+                else if( ovf_buf < 0 )
+                {
+                    ovf_buf = buf_idx;
+                }
+            }
+        }
+
+        // Frame matched only full buffers (i.e. the frame was lost) ?
+        if( ( stored == false ) && ( ovf_buf >= 0 ) )
+        {
+            hostsim_C1RXOVF1 |= (uint16_t) ( 1U << ovf_buf );
+            HostsimCanIntSet( 0x0004 );
+        }
+    }
+}
+
+void HostsimCanBitrateSet ( uint8_t brp )
+{
+    hostsim_can_brp = brp;
+}
+
+void HostsimAdcSet ( uint8_t ain, uint16_t val )
+{
+    if( ain < HOSTSIM_AIN_NUM_OF )
+    {
+        hostsim_ain[ ain ] = val & 0x0FFFU;
+    }
+}
+
+void HostsimIna219Set ( uint16_t bus_reg, uint16_t cur_reg )
+{
+    hostsim_ina219_reg[ HOSTSIM_INA219_BUS_VOLT ] = bus_reg;
+    hostsim_ina219_reg[ HOSTSIM_INA219_CURRENT  ] = cur_reg;
+}
+
+void HostsimReset ( void )
+{
+    HostsimStop( HOSTSIM_STOP_RESET );
+}
+
+// ---- Register accesses with hardware behavior (see xc.h) --------------------
+
+volatile HOSTSIM_AD1CON1_U* HostsimAd1con1Get ( void )
+{
+    // Sampling started - complete the conversion of the selected input.
+    if( hostsim_AD1CON1.bits.SAMP == 1 )
+    {
+        hostsim_ADC1BUF0             = hostsim_ain[ hostsim_AD1CHS0.bits.CH0SA % HOSTSIM_AIN_NUM_OF ];
+        hostsim_AD1CON1.bits.SAMP    = 0;
+        hostsim_AD1CON1.bits.DONE    = 1;
+    }
+
+    return &hostsim_AD1CON1;
+}
+
+volatile HOSTSIM_C1CTRL1_U* HostsimC1ctrl1Get ( void )
+{
+    // The requested operating mode is entered - on entry to Configuration
+    // Mode the FIFO is reset.
+    if( ( hostsim_C1CTRL1.bits.REQOP  == 4 ) &&
+        ( hostsim_C1CTRL1.bits.OPMODE != 4 ) )
+    {
+        hostsim_can_fifo_wr = 0;
+        hostsim_can_fifo_rd = 0;
+    }
+
+    hostsim_C1CTRL1.bits.OPMODE = hostsim_C1CTRL1.bits.REQOP;
+
+    return &hostsim_C1CTRL1;
+}
+
+volatile HOSTSIM_C1FIFO_U* HostsimC1fifoGet ( void )
+{
+    uint8_t fifo_start = hostsim_C1FCTRL.bits.FSA;
+    uint8_t fifo_len   = 16U - fifo_start;
+
+    // Advance the next buffer to be read over the buffers read (i.e. RXFUL
+    // cleared by software).
+    while( ( hostsim_can_fifo_rd != hostsim_can_fifo_wr ) &&
+           ( ( hostsim_C1RXFUL1 & ( 1U << ( fifo_start + ( hostsim_can_fifo_rd % fifo_len ) ) ) ) == 0 ) )
+    {
+        hostsim_can_fifo_rd++;
+    }
+
+    hostsim_C1FIFO.bits.FNRB = fifo_start + ( hostsim_can_fifo_rd % fifo_len );
+    hostsim_C1FIFO.bits.FBP  = fifo_start + ( hostsim_can_fifo_wr % fifo_len );
+
+    return &hostsim_C1FIFO;
+}
+
+volatile uint16_t* HostsimTmr1Get ( void )
+{
+    HostsimTmrUpdate( &hostsim_tmr1 );
+
+    return &hostsim_TMR1;
+}
+
+volatile uint16_t* HostsimTmr2Get ( void )
+{
+    // Each read of the counter advances the time, so that busy-waits on the
+    // counter terminate.
+    hostsim_cyc++;
+    HostsimUpdate();
+
+    return &hostsim_TMR2;
+}
+
+volatile uint16_t* HostsimTmr4Get ( void )
+{
+    HostsimTmrUpdate( &hostsim_tmr4 );
+
+    return &hostsim_TMR4;
+}
+
+// ---- Instruction and compiler built-in substitutes (see xc.h) ---------------
+
+void HostsimWdtClear ( void )
+{
+    hostsim_wdt_cyc = hostsim_cyc;
+}
+
+int32_t HostsimMulss ( int16_t a, int16_t b )
+{
+    hostsim_op_cnt.mul_cnt++;
+
+    return (int32_t) a * b;
+}
+
+int32_t HostsimMulsu ( int16_t a, uint16_t b )
+{
+    hostsim_op_cnt.mul_cnt++;
+
+    return (int32_t) a * (int32_t) b;
+}
+
+uint32_t HostsimMuluu ( uint16_t a, uint16_t b )
+{
+    hostsim_op_cnt.mul_cnt++;
+
+    return (uint32_t) a * b;
+}
+
+// Function entry/exit of the firmware modules (-finstrument-functions).
+void __cyg_profile_func_enter ( void* func, void* call_site ) __attribute__(( no_instrument_function ));
+void __cyg_profile_func_exit  ( void* func, void* call_site ) __attribute__(( no_instrument_function ));
+
+void __cyg_profile_func_enter ( void* func, void* call_site )
+{
+    (void) func;
+    (void) call_site;
+
+    hostsim_op_cnt.call_cnt++;
+}
+
+void __cyg_profile_func_exit ( void* func, void* call_site )
+{
+    (void) func;
+    (void) call_site;
+}
+
+// ---- NVM driver model -------------------------------------------------------
+
+void NVMInit ( void )
+{
+}
+
+bool NVMErasePage ( uint16_t table_page,
+                    uint16_t table_offset )
+{
+    uint8_t*  page = (uint8_t*) (uintptr_t) ( ( (uint32_t) table_page << 16 ) | table_offset );
+    uintptr_t prot_size = (uintptr_t) sysconf( _SC_PAGESIZE );
+    uintptr_t prot_start = (uintptr_t) page & ~( prot_size - 1U );
+
+    // Program Memory constants are in a read-only host segment.
+    (void) mprotect( (void*) prot_start,
+                     ( (uintptr_t) page + HOSTSIM_NVM_PAGE_BYTES ) - prot_start,
+                     PROT_READ | PROT_WRITE );
+
+    memset( page, 0xFF, HOSTSIM_NVM_PAGE_BYTES );
+
+    return false;
+}
+
+bool NVMProgramPage ( const uint16_t src_data[],
+                      uint16_t table_page,
+                      uint16_t table_offset )
+{
+    uint16_t* page = (uint16_t*) (uintptr_t) ( ( (uint32_t) table_page << 16 ) | table_offset );
+    uint16_t  word_idx;
+
+    // Note: Programming only clears bits - a page which is not erased is
+    // not programmed with the source data.
+    for( word_idx = 0;
+         word_idx < HOSTSIM_NVM_PAGE_BYTES / 2U;
+         word_idx++ )
+    {
+        page[ word_idx ] &= src_data[ word_idx ];
+    }
+
+    return false;
+}
+
+// ---- I2C driver model (INA219) ----------------------------------------------
+
+void I2CInit( void )
+{
+}
+
+void I2CWrite( uint8_t saddr, const uint8_t* data, uint8_t data_len )
+{
+    if( ( saddr    == HOSTSIM_INA219_SADDR ) &&
+        ( data_len >= 1U                   ) )
+    {
+        hostsim_ina219_ptr = data[ 0 ] % HOSTSIM_INA219_REG_NUM_OF;
+
+        if( data_len >= 3U )
+        {
+            hostsim_ina219_reg[ hostsim_ina219_ptr ] = (uint16_t) ( ( data[ 1 ] << 8 ) | data[ 2 ] );
+        }
+    }
+}
+
+void I2CRead( uint8_t saddr, uint8_t* data, uint8_t data_len )
+{
+    uint16_t val = 0xFFFF;
+    int16_t  data_idx;
+
+    if( saddr == HOSTSIM_INA219_SADDR )
+    {
+        val = hostsim_ina219_reg[ hostsim_ina219_ptr ];
+    }
+
+    // Note: As the driver, the first (most significant) byte received is
+    // stored last.
+    for( data_idx  = data_len - 1;
+         data_idx >= 0;
+         data_idx-- )
+    {
+        data[ data_idx ] = (uint8_t) ( val >> 8 );
+        val = (uint16_t) ( val << 8 );
+    }
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Update the hardware state to the present simulation time.
+////////////////////////////////////////////////////////////////////////////////
+static void HostsimUpdate ( void )
+{
+    HostsimTmrUpdate( &hostsim_tmr1 );
+    HostsimTmrUpdate( &hostsim_tmr4 );
+    HostsimTmr23Update();
+    HostsimCanTxUpdate();
+
+    // Watchdog timeout ?
+    // Note: The timer is cleared while disabled.
+    if( hostsim_RCON.bits.SWDTEN == 0 )
+    {
+        hostsim_wdt_cyc = hostsim_cyc;
+    }
+    else if( hostsim_cyc - hostsim_wdt_cyc >= HOSTSIM_WDT_CYC )
+    {
+        HostsimStop( HOSTSIM_STOP_WDT );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Stop the simulation - return to the running HostsimStart or
+///         HostsimRun.
+////////////////////////////////////////////////////////////////////////////////
+static void HostsimStop ( HOSTSIM_STOP_E stop )
+{
+    hostsim_stop = stop;
+
+    longjmp( hostsim_stop_jmp, 1 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the priority level of an interrupt.
+////////////////////////////////////////////////////////////////////////////////
+static uint16_t HostsimIplGet ( HOSTSIM_ISR_E isr )
+{
+    uint16_t ipl = 0;
+
+    switch( isr )
+    {
+        case HOSTSIM_ISR_T1: ipl = hostsim_IPC0.bits.T1IP; break;
+        case HOSTSIM_ISR_T3: ipl = hostsim_IPC2.bits.T3IP; break;
+        case HOSTSIM_ISR_T4: ipl = hostsim_IPC6.bits.T4IP; break;
+        case HOSTSIM_ISR_C1: ipl = hostsim_IPC8.bits.C1IP; break;
+        default:                                           break;
+    }
+
+    return ipl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Execute the pending interrupts, in order of priority.
+////////////////////////////////////////////////////////////////////////////////
+static void HostsimIsrDispatch ( void )
+{
+    HOSTSIM_ISR_E isr;
+    HOSTSIM_ISR_E isr_sel;
+    uint16_t      ipl_sel;
+    uint16_t      isr_cnt = 0;
+
+    do
+    {
+        isr_sel = HOSTSIM_ISR_NUM_OF;
+        ipl_sel = 0;
+
+        if( hostsim_INTCON2.bits.GIE == 1 )
+        {
+            for( isr = (HOSTSIM_ISR_E) 0;
+                 isr < HOSTSIM_ISR_NUM_OF;
+                 isr++ )
+            {
+                if( ( ( *hostsim_isr[ isr ].ifs & hostsim_isr[ isr ].mask ) != 0 ) &&
+                    ( ( *hostsim_isr[ isr ].iec & hostsim_isr[ isr ].mask ) != 0 ) &&
+                    ( hostsim_isr_hold[ isr ] == false                       ) &&
+                    ( HostsimIplGet( isr ) > ipl_sel ) )
+                {
+                    isr_sel = isr;
+                    ipl_sel = HostsimIplGet( isr );
+                }
+            }
+        }
+
+        if( isr_sel != HOSTSIM_ISR_NUM_OF )
+        {
+            isr_cnt++;
+            if( isr_cnt > HOSTSIM_ISR_BURST_MAX )
+            {
+                HostsimStop( HOSTSIM_STOP_ISR );
+            }
+
+            if( hostsim_hook.isr_start != NULL )
+            {
+                hostsim_hook.isr_start( isr_sel );
+            }
+
+            hostsim_isr[ isr_sel ].isr();
+
+            if( hostsim_hook.isr_end != NULL )
+            {
+                hostsim_hook.isr_end( isr_sel );
+            }
+
+            if( ( hostsim_PDC3   != hostsim_pdc_last ) &&
+                ( hostsim_hook.pwm != NULL           ) )
+            {
+                hostsim_hook.pwm( hostsim_PDC3 );
+            }
+            hostsim_pdc_last = hostsim_PDC3;
+
+            HostsimUpdate();
+        }
+    }
+    while( isr_sel != HOSTSIM_ISR_NUM_OF );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the time of the next event of the model.
+///
+/// @param  cyc_end
+///             The latest time returned.
+////////////////////////////////////////////////////////////////////////////////
+static uint64_t HostsimEventNext ( uint64_t cyc_end )
+{
+    uint64_t cyc_next = cyc_end;
+    uint64_t cyc_event;
+
+    cyc_event = HostsimTmrEventNext( &hostsim_tmr1 );
+    if( cyc_event < cyc_next ) { cyc_next = cyc_event; }
+
+    cyc_event = HostsimTmrEventNext( &hostsim_tmr4 );
+    if( cyc_event < cyc_next ) { cyc_next = cyc_event; }
+
+    if( hostsim_tmr23_on == true )
+    {
+        cyc_event = hostsim_tmr23_base + ( ( hostsim_tmr23_roll + 1U ) << 32 );
+        if( cyc_event < cyc_next ) { cyc_next = cyc_event; }
+    }
+
+    if( hostsim_can_tx_buf != HOSTSIM_CAN_TX_NUM_OF )
+    {
+        if( hostsim_can_tx_end < cyc_next ) { cyc_next = hostsim_can_tx_end; }
+    }
+
+    if( hostsim_RCON.bits.SWDTEN == 1 )
+    {
+        cyc_event = hostsim_wdt_cyc + HOSTSIM_WDT_CYC;
+        if( cyc_event < cyc_next ) { cyc_next = cyc_event; }
+    }
+
+    return cyc_next;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Update a 16-bit timer to the present simulation time.
+////////////////////////////////////////////////////////////////////////////////
+static void HostsimTmrUpdate ( HOSTSIM_TMR_S* tmr )
+{
+    static const uint16_t presc[ 4 ] = { 1, 8, 64, 256 };
+
+    uint32_t tmr_presc = presc[ ( *tmr->con >> 4 ) & 0x3U ];
+    uint64_t tmr_val;
+    uint64_t tmr_period;
+
+    // Timer is enabled ?
+    if( ( *tmr->con & 0x8000U ) != 0 )
+    {
+        tmr_val  = ( tmr->presc_acc + ( hostsim_cyc - tmr->cyc_last ) ) / tmr_presc;
+        tmr->presc_acc = (uint32_t) ( ( tmr->presc_acc + ( hostsim_cyc - tmr->cyc_last ) ) % tmr_presc );
+
+        // The timer is reset on the count following the period match.
+        tmr_val   += *tmr->tmr;
+        tmr_period = (uint64_t) *tmr->pr + 1U;
+
+        if( tmr_val >= tmr_period )
+        {
+            *tmr->ifs |= tmr->if_mask;
+        }
+
+        *tmr->tmr = (uint16_t) ( tmr_val % tmr_period );
+    }
+
+    tmr->cyc_last = hostsim_cyc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the time of the next period match of a 16-bit timer.
+////////////////////////////////////////////////////////////////////////////////
+static uint64_t HostsimTmrEventNext ( const HOSTSIM_TMR_S* tmr )
+{
+    static const uint16_t presc[ 4 ] = { 1, 8, 64, 256 };
+
+    uint32_t tmr_presc = presc[ ( *tmr->con >> 4 ) & 0x3U ];
+    uint64_t cyc_next  = UINT64_MAX;
+
+    if( ( *tmr->con & 0x8000U ) != 0 )
+    {
+        cyc_next = hostsim_cyc +
+                   ( ( (uint64_t) *tmr->pr + 1U - *tmr->tmr ) * tmr_presc ) - tmr->presc_acc;
+    }
+
+    return cyc_next;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Update the 32-bit Timer2/3 to the present simulation time.
+////////////////////////////////////////////////////////////////////////////////
+static void HostsimTmr23Update ( void )
+{
+    uint64_t tick;
+
+    if( hostsim_T2CON.bits.TON == 1 )
+    {
+        if( hostsim_tmr23_on == false )
+        {
+            hostsim_tmr23_on   = true;
+            hostsim_tmr23_base = hostsim_cyc - ( ( (uint32_t) hostsim_TMR3 << 16 ) | hostsim_TMR2 );
+            hostsim_tmr23_roll = 0;
+        }
+
+        tick = hostsim_cyc - hostsim_tmr23_base;
+
+        // Roll-over of the 32-bit counter ?
+        if( ( tick >> 32 ) != hostsim_tmr23_roll )
+        {
+            hostsim_tmr23_roll   = tick >> 32;
+            hostsim_IFS0.bits.T3IF = 1;
+        }
+
+        // Note: The upper word is latched by the read of the lower word.
+        hostsim_TMR2    = (uint16_t) tick;
+        hostsim_TMR3    = (uint16_t) ( tick >> 16 );
+        hostsim_TMR3HLD = hostsim_TMR3;
+    }
+    else
+    {
+        hostsim_tmr23_on = false;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Set ECAN interrupt flags, and the CAN1 interrupt flag if enabled.
+///
+/// @param  intf_mask
+///             The flags set (C1INTF bits).
+////////////////////////////////////////////////////////////////////////////////
+static void HostsimCanIntSet ( uint16_t intf_mask )
+{
+    hostsim_C1INTF.reg |= intf_mask;
+
+    if( ( hostsim_C1INTE.reg & intf_mask ) != 0 )
+    {
+        hostsim_IFS2.bits.C1IF = 1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Update the transmit buffers to the present simulation time -
+///         complete the transmission in progress, and start the
+///         transmission of the highest priority requested buffer.
+////////////////////////////////////////////////////////////////////////////////
+static void HostsimCanTxUpdate ( void )
+{
+    volatile uint16_t (*can_buf)[ 8 ];
+
+    uint8_t  buf_idx;
+    uint8_t  buf_sel;
+    uint16_t ctrl;
+    int16_t  pri_sel;
+    uint8_t  data_idx;
+    uint32_t sid;
+    uint32_t eid;
+
+    // Transmission complete ?
+    if( ( hostsim_can_tx_buf != HOSTSIM_CAN_TX_NUM_OF ) &&
+        ( hostsim_cyc        >= hostsim_can_tx_end    ) )
+    {
+        buf_idx = hostsim_can_tx_buf;
+        hostsim_can_tx_buf = HOSTSIM_CAN_TX_NUM_OF;
+
+        *hostsim_can_trcon[ buf_idx / 2U ] &= (uint16_t) ~( 0x0008U << ( ( buf_idx % 2U ) * 8U ) );
+        HostsimCanIntSet( 0x0001 );
+
+        if( hostsim_hook.can_tx != NULL )
+        {
+            hostsim_hook.can_tx( &hostsim_can_tx_frame );
+        }
+    }
+
+    // Bus is idle in Normal Operating Mode ?
+    if( ( hostsim_can_tx_buf          == HOSTSIM_CAN_TX_NUM_OF ) &&
+        ( hostsim_C1CTRL1.bits.OPMODE == 0                     ) )
+    {
+        // Select the requested buffer of highest priority level (the
+        // highest-indexed buffer at equal level).
+        buf_sel = HOSTSIM_CAN_TX_NUM_OF;
+        pri_sel = -1;
+
+        for( buf_idx = 0;
+             buf_idx < HOSTSIM_CAN_TX_NUM_OF;
+             buf_idx++ )
+        {
+            ctrl = (uint16_t) ( *hostsim_can_trcon[ buf_idx / 2U ] >> ( ( buf_idx % 2U ) * 8U ) );
+
+            if( ( ( ctrl & 0x0088U ) == 0x0088U ) &&
+                ( (int16_t) ( ctrl & 0x3U ) >= pri_sel ) )
+            {
+                buf_sel = buf_idx;
+                pri_sel = (int16_t) ( ctrl & 0x3U );
+            }
+        }
+
+        if( buf_sel != HOSTSIM_CAN_TX_NUM_OF )
+        {
+            can_buf = HostsimCanBufGet();
+
+            // Decode the frame from the buffer (see the ECAN buffer format).
+            sid = ( can_buf[ buf_sel ][ 0 ] >> 2 ) & 0x7FFU;
+            eid = ( (uint32_t) ( can_buf[ buf_sel ][ 1 ] & 0x0FFFU ) << 6 ) |
+                  ( ( can_buf[ buf_sel ][ 2 ] >> 10 ) & 0x3FU );
+
+            hostsim_can_tx_frame.ide = ( ( can_buf[ buf_sel ][ 0 ] & 0x0001U ) != 0 );
+            hostsim_can_tx_frame.id  = ( hostsim_can_tx_frame.ide == true ) ? ( ( sid << 18 ) | eid ) : sid;
+            hostsim_can_tx_frame.dlc = can_buf[ buf_sel ][ 2 ] & 0x0FU;
+
+            if( hostsim_can_tx_frame.dlc > 8U )
+            {
+                hostsim_can_tx_frame.dlc = 8U;
+            }
+
+            for( data_idx = 0;
+                 data_idx < 8U;
+                 data_idx++ )
+            {
+                hostsim_can_tx_frame.data[ data_idx ] = (uint8_t) ( can_buf[ buf_sel ][ 3U + ( data_idx / 2U ) ] >> ( ( data_idx % 2U ) * 8U ) );
+            }
+
+            // Frame time - bits of an extended frame (excluding bit stuffing)
+            // at 20 * ( BRP + 1 ) cycles per bit (10 TQ per bit).
+            hostsim_can_tx_buf = buf_sel;
+            hostsim_can_tx_end = hostsim_cyc +
+                                 ( 67U + ( 8U * hostsim_can_tx_frame.dlc ) ) *
+                                 ( 20U * ( hostsim_C1CFG1.bits.BRP + 1U ) );
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return whether a frame matches an enabled acceptance filter.
+////////////////////////////////////////////////////////////////////////////////
+static bool HostsimCanFltMatch ( uint8_t flt_idx, const HOSTSIM_CAN_FRAME_S* frame )
+{
+    volatile HOSTSIM_C1RXF0SID_U* flt_sid = hostsim_can_flt_sid[ flt_idx ];
+    volatile HOSTSIM_C1RXM0SID_U* msk_sid;
+    uint16_t msk_eid;
+    uint8_t  msk_sel;
+    uint32_t flt_id;
+    uint32_t msk_id;
+    uint32_t frame_id;
+    bool     match = false;
+
+    msk_sel = ( hostsim_C1FMSKSEL1.reg >> ( flt_idx * 2U ) ) & 0x3U;
+
+    if( ( ( hostsim_C1FEN1.reg & ( 1U << flt_idx ) ) != 0 ) &&
+        ( msk_sel < 2U ) )
+    {
+        msk_sid = ( msk_sel == 0 ) ? &hostsim_C1RXM0SID :
+                                     (volatile HOSTSIM_C1RXM0SID_U*) &hostsim_C1RXM1SID;
+        msk_eid = ( msk_sel == 0 ) ? hostsim_C1RXM0EID : hostsim_C1RXM1EID;
+
+        // Compare the 29-bit identifiers (SID<10:0>, EID<17:0>).
+        flt_id   = ( (uint32_t) flt_sid->bits.SID << 18 ) | ( (uint32_t) flt_sid->bits.EID << 16 ) | *hostsim_can_flt_eid[ flt_idx ];
+        msk_id   = ( (uint32_t) msk_sid->bits.SID << 18 ) | ( (uint32_t) msk_sid->bits.EID << 16 ) | msk_eid;
+        frame_id = ( frame->ide == true ) ? frame->id : ( frame->id << 18 );
+
+        // Note: Standard identifiers match the filter's SID only.
+        if( frame->ide == false )
+        {
+            msk_id &= 0x1FFC0000UL;
+        }
+
+        match = ( ( ( frame_id ^ flt_id ) & msk_id ) == 0 );
+
+        // Identifier type must match the filter ?
+        if( ( msk_sid->bits.MIDE == 1 ) &&
+            ( flt_sid->bits.EXIDE != ( frame->ide == true ? 1U : 0U ) ) )
+        {
+            match = false;
+        }
+    }
+
+    return match;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Store a received frame in a receive buffer.
+////////////////////////////////////////////////////////////////////////////////
+static void HostsimCanStore ( uint8_t buf_idx, uint8_t flt_idx, const HOSTSIM_CAN_FRAME_S* frame )
+{
+    volatile uint16_t (*can_buf)[ 8 ] = HostsimCanBufGet();
+
+    uint32_t sid = ( frame->ide == true ) ? ( frame->id >> 18 ) & 0x7FFU : frame->id & 0x7FFU;
+    uint32_t eid = ( frame->ide == true ) ? frame->id & 0x3FFFFUL : 0;
+    uint8_t  data_idx;
+
+    can_buf[ buf_idx ][ 0 ] = (uint16_t) ( ( sid << 2 ) | ( frame->ide == true ? 0x0003U : 0 ) );
+    can_buf[ buf_idx ][ 1 ] = (uint16_t) ( eid >> 6 );
+    can_buf[ buf_idx ][ 2 ] = (uint16_t) ( ( ( eid & 0x3FU ) << 10 ) | ( frame->dlc & 0x0FU ) );
+
+    for( data_idx = 0;
+         data_idx < 4U;
+         data_idx++ )
+    {
+        can_buf[ buf_idx ][ 3U + data_idx ] = (uint16_t) ( frame->data[ data_idx * 2U ] |
+                                                           ( frame->data[ ( data_idx * 2U ) + 1U ] << 8 ) );
+    }
+
+    can_buf[ buf_idx ][ 7 ] = (uint16_t) ( flt_idx << 8 );
+
+    hostsim_C1RXFUL1 |= (uint16_t) ( 1U << buf_idx );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the ECAN message buffers (the DMA start address).
+////////////////////////////////////////////////////////////////////////////////
+static volatile uint16_t (*HostsimCanBufGet ( void ))[ 8 ]
+{
+    return (volatile uint16_t (*)[ 8 ]) (uintptr_t) hostsim_DMA1STAL;
+}
\ No newline at end of file
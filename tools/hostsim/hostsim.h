@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host simulation of the firmware.
+///
+/// The firmware modules are compiled for the host against a register fake
+/// (see xc.h) and executed by an event-driven model of the hardware used by
+/// the firmware:
+///
+///     - instruction cycle clock (Fcy = 20MHz) and Timers 1-4, with the
+///       Timer1 software cycle, Timer2/3 roll-over, and Timer4 one-shot
+///       interrupts.
+///     - ECAN acceptance filters, receive buffers and FIFO, and the
+///       transmit buffers, with the bus time of each transmitted frame.
+///     - ADC conversion of the VSENSE1/2 inputs.
+///     - INA219 registers behind the I2C driver interface.
+///     - NVM page erase/program behind the NVM driver interface.
+///     - watchdog timeout and the software reset instruction.
+///
+/// Interrupts are executed in order of priority when pending and enabled,
+/// between events of the model.  Firmware execution takes no simulated time,
+/// except that each read of the instruction cycle counter (TMR2) advances
+/// the clock by one cycle, so that busy-waits on the counter terminate.
+///
+/// @note   Interrupts do not preempt one another or the firmware's own
+///         busy-waits (an interrupt pending during a busy-wait is executed
+///         on its completion), and bus arbitration between received and
+///         transmitted frames is not modeled.  The background thread is not
+///         executed, so that the background thread calibration is omitted
+///         and the CPU load is annunciated as zero.
+///
+/// @note   A software reset or watchdog timeout stops the simulation (the
+///         firmware's static data is not re-initialized on the host).
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOSTSIM_H_
+#define HOSTSIM_H_
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define HOSTSIM_CYC_PER_US      20U     ///< Instruction cycles per micro-second.
+
+/// CAN frame on the simulated bus.
+typedef struct
+{
+    uint32_t id;            ///< Identifier (29-bit if extended, 11-bit otherwise).
+    bool     ide;           ///< Extended identifier.
+    uint8_t  dlc;           ///< Data length (0-8).
+    uint8_t  data[ 8 ];     ///< Data bytes.
+
+} HOSTSIM_CAN_FRAME_S;
+
+/// Interrupts executed by the simulation.
+typedef enum
+{
+    HOSTSIM_ISR_T1,         ///< Software cycle (Timer1).
+    HOSTSIM_ISR_T3,         ///< Timer roll-over (Timer2/3).
+    HOSTSIM_ISR_T4,         ///< One-shot (Timer4).
+    HOSTSIM_ISR_C1,         ///< CAN1.
+    HOSTSIM_ISR_NUM_OF
+
+} HOSTSIM_ISR_E;
+
+/// Conditions which stop the simulation.
+typedef enum
+{
+    HOSTSIM_STOP_NONE,      ///< Simulation is running.
+    HOSTSIM_STOP_RESET,     ///< Software reset instruction executed.
+    HOSTSIM_STOP_WDT,       ///< Watchdog timeout.
+    HOSTSIM_STOP_ISR,       ///< Interrupt flag not cleared by its interrupt.
+
+} HOSTSIM_STOP_E;
+
+/// Operation counts of the firmware execution (free-running).
+typedef struct
+{
+    uint32_t call_cnt;      ///< Function executions (instrumented function entries).
+    uint32_t mul_cnt;       ///< 16x16-bit hardware multiplications (__builtin_mulss/mulsu/muluu).
+
+} HOSTSIM_OP_CNT_S;
+
+/// Observation of the simulation (each member is optional).
+typedef struct
+{
+    void (*can_tx)( const HOSTSIM_CAN_FRAME_S* frame );    ///< Frame transmission complete.
+    void (*pwm)( uint16_t pdc );                            ///< PWM duty cycle register (PDC3) changed.
+    void (*isr_start)( HOSTSIM_ISR_E isr );                 ///< Interrupt execution start.
+    void (*isr_end)( HOSTSIM_ISR_E isr );                   ///< Interrupt execution end.
+
+} HOSTSIM_HOOK_S;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Power-on the simulated node and execute the firmware start-up.
+///
+/// @param  hook
+///             Observation of the simulation (NULL for none).
+///
+/// @return true  - start-up complete.
+///         false - simulation stopped (see HostsimStopGet).
+///
+/// @note   The start-up sequence is that of main(), excluding the
+///         background thread calibration and the benchmark.
+////////////////////////////////////////////////////////////////////////////////
+bool HostsimStart ( const HOSTSIM_HOOK_S* hook );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Execute the simulation until a time.
+///
+/// @param  cyc_end
+///             The time at which execution ends (LSB = 1 instruction cycle).
+///
+/// @return true  - time reached.
+///         false - simulation stopped (see HostsimStopGet).
+////////////////////////////////////////////////////////////////////////////////
+bool HostsimRun ( uint64_t cyc_end );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the simulation time (LSB = 1 instruction cycle).
+////////////////////////////////////////////////////////////////////////////////
+uint64_t HostsimCycGet ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the condition which stopped the simulation.
+////////////////////////////////////////////////////////////////////////////////
+HOSTSIM_STOP_E HostsimStopGet ( void );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the operation counts of the firmware execution.
+///
+/// @param  op_cnt
+///             The operation counts.
+///
+/// @note   The counts are a target-independent measure of the firmware's
+///         execution cost - e.g. the difference of the counts at the start
+///         and end of an interrupt (see HOSTSIM_HOOK_S).
+////////////////////////////////////////////////////////////////////////////////
+void HostsimOpCntGet ( HOSTSIM_OP_CNT_S* op_cnt );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Hold an interrupt pending, or release it.
+///
+/// @param  isr
+///             The interrupt.
+/// @param  hold
+///             true  - the interrupt is not executed while pending.
+///             false - the interrupt is executed when pending (default).
+///
+/// @note   The firmware executes in zero simulation time, so an interrupt is
+///         otherwise executed as soon as its flag is set.  Holding it models
+///         the latency of a target interrupt (e.g. while a higher priority
+///         thread executes), over which several hardware events occur.
+////////////////////////////////////////////////////////////////////////////////
+void HostsimIsrHold ( HOSTSIM_ISR_E isr, bool hold );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Receive a frame from the bus at the present simulation time.
+///
+/// @param  frame
+///             The received frame.
+///
+/// @note   The frame is only received if the ECAN module is in Normal or
+///         Listen Only Mode, at the bit rate of the bus.
+////////////////////////////////////////////////////////////////////////////////
+void HostsimCanRx ( const HOSTSIM_CAN_FRAME_S* frame );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Set the bit rate of the bus traffic.
+///
+/// @param  brp
+///             The ECAN baud rate prescaler at which frames are received
+///             (0 = 1Mbps, 1 = 500kbps, 3 = 250kbps, 7 = 125kbps).
+////////////////////////////////////////////////////////////////////////////////
+void HostsimCanBitrateSet ( uint8_t brp );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Set the value converted from an analog input.
+///
+/// @param  ain
+///             The analog input (AN0-AN31).
+/// @param  val
+///             The 12-bit conversion value.
+////////////////////////////////////////////////////////////////////////////////
+void HostsimAdcSet ( uint8_t ain, uint16_t val );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Set the measurement registers of the INA219.
+///
+/// @param  bus_reg
+///             The Bus Voltage register value.
+/// @param  cur_reg
+///             The Current register value.
+////////////////////////////////////////////////////////////////////////////////
+void HostsimIna219Set ( uint16_t bus_reg, uint16_t cur_reg );
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Execute the software reset instruction (see xc.h).
+///
+/// @note   Function does not return.
+////////////////////////////////////////////////////////////////////////////////
+void HostsimReset ( void ) __attribute__(( noreturn ));
+
+#endif // HOSTSIM_H_
\ No newline at end of file
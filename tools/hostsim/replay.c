@@ -0,0 +1,387 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host replay of recorded CAN traffic through the firmware.
+///
+/// A recorded CAN log (candump -L format) is replayed through the firmware
+/// on the host simulation (see hostsim.h), and the firmware's outputs are
+/// written in order of occurrence:
+///
+///     (sec.usec) rx ID#DATA calls=n mul=n     - frame received by the node,
+///                                               with the operation counts
+///                                               of the CAN interrupt(s)
+///                                               which processed it.
+///     (sec.usec) tx ID#DATA                   - frame transmitted by the node.
+///     (sec.usec) pwm n                        - PWM duty cycle register (PDC3).
+///     (sec.usec) stop reset|wdt|isr           - simulation stopped.
+///
+/// followed by the number of executions and the maximum and mean operation
+/// counts (see HostsimOpCntGet) of each interrupt.  The output is
+/// deterministic, so that the output of a build is compared with that of
+/// a previous build (the golden output) to identify changes of behavior
+/// and of execution cost (see 'make check').
+///
+/// Frames from the FMU (source Node ID 0) are received by the node at their
+/// logged time, relative to the first frame of the log, which is received
+/// REPLAY_START_US after power-on.  Frames of other nodes (i.e. the node's
+/// own transmissions in the recorded traffic) are not received; instead, the
+/// sensor inputs are replayed from them:
+///
+///     VSENSE Data     - the raw VSENSE1/2 values set the ADC conversions.
+///     Servo Status    - the servo voltage and current set the INA219 Bus
+///                       Voltage and Current registers.
+///
+/// so that a log recorded on the bench (e.g. 'candump -L can0') replays the
+/// commands and the sensor inputs of the recording.
+///
+/// Usage:
+///
+///     replay <log>
+///
+/// @note   The sensor inputs are applied from the time of the annunciating
+///         message, which follows their sampling by up to one task period.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "hostsim.h"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define REPLAY_START_US         100000U     ///< Reception time of the first frame after power-on.
+#define REPLAY_END_US           100000U     ///< Execution time following the last frame.
+#define REPLAY_LINE_LEN         256U        ///< Maximum length of a log line.
+
+#define REPLAY_DT_SERVO_STATUS  20U         ///< Servo Status data type.
+#define REPLAY_DT_VSENSE_DATA   21U         ///< VSENSE Data data type.
+
+#define REPLAY_AIN_VSENSE1      2U          ///< Analog input of VSENSE1 (AN2).
+#define REPLAY_AIN_VSENSE2      3U          ///< Analog input of VSENSE2 (AN3).
+
+/// Operation count statistics of an interrupt.
+typedef struct
+{
+    uint32_t cnt;           ///< Number of executions.
+    uint32_t call_max;      ///< Maximum function executions.
+    uint64_t call_sum;      ///< Accumulated function executions.
+    uint32_t mul_max;       ///< Maximum multiplications.
+    uint64_t mul_sum;       ///< Accumulated multiplications.
+
+} REPLAY_ISR_STAT_S;
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Operation counts at the start of the executing interrupt.
+static HOSTSIM_OP_CNT_S replay_op_start;
+
+/// Operation count statistics of each interrupt.
+static REPLAY_ISR_STAT_S replay_isr_stat[ HOSTSIM_ISR_NUM_OF ];
+
+/// Operation counts of the CAN interrupt(s) processing the received frame.
+static HOSTSIM_OP_CNT_S replay_rx_op;
+
+/// Interrupt names.
+static const char* const replay_isr_name[ HOSTSIM_ISR_NUM_OF ] =
+{
+    "T1", "T3", "T4", "C1",
+};
+
+/// Stop condition names.
+static const char* const replay_stop_name[] =
+{
+    "none", "reset", "wdt", "isr",
+};
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+static void     ReplayTimePrint ( void );
+static void     ReplayFramePrint ( const char* dir, const HOSTSIM_CAN_FRAME_S* frame );
+static void     ReplayCanTx ( const HOSTSIM_CAN_FRAME_S* frame );
+static void     ReplayPwm ( uint16_t pdc );
+static void     ReplayIsrStart ( HOSTSIM_ISR_E isr );
+static void     ReplayIsrEnd ( HOSTSIM_ISR_E isr );
+static bool     ReplayLineParse ( const char* line, uint64_t* time_us, HOSTSIM_CAN_FRAME_S* frame );
+static void     ReplaySensorSet ( const HOSTSIM_CAN_FRAME_S* frame );
+static uint16_t ReplayU16Get ( const uint8_t data[] );
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+int main ( int argc, char* argv[] )
+{
+    static const HOSTSIM_HOOK_S hook = { ReplayCanTx, ReplayPwm, ReplayIsrStart, ReplayIsrEnd };
+
+    FILE*    log_file;
+    char     line[ REPLAY_LINE_LEN ];
+    uint64_t time_us;
+    uint64_t time_first = 0;
+    bool     first      = true;
+    bool     running;
+    uint8_t  isr;
+
+    HOSTSIM_CAN_FRAME_S frame;
+
+    if( argc != 2 )
+    {
+        fprintf( stderr, "usage: replay <log>\n" );
+        return EXIT_FAILURE;
+    }
+
+    log_file = fopen( argv[ 1 ], "r" );
+    if( log_file == NULL )
+    {
+        perror( argv[ 1 ] );
+        return EXIT_FAILURE;
+    }
+
+    running = HostsimStart( &hook );
+
+    while( ( running == true ) &&
+           ( fgets( line, sizeof( line ), log_file ) != NULL ) )
+    {
+        if( ReplayLineParse( line, &time_us, &frame ) == true )
+        {
+            if( first == true )
+            {
+                time_first = time_us;
+                first      = false;
+            }
+
+            running = HostsimRun( ( REPLAY_START_US + ( time_us - time_first ) ) * HOSTSIM_CYC_PER_US );
+
+            // Frame from the FMU ?
+            if( ( running == true ) &&
+                ( ( ( frame.id >> 10 ) & 0x7FU ) == 0 ) )
+            {
+                // Receive the frame, and execute its processing by the CAN
+                // interrupt.
+                memset( &replay_rx_op, 0, sizeof( replay_rx_op ) );
+
+                HostsimCanRx( &frame );
+                running = HostsimRun( HostsimCycGet() + 1U );
+
+                ReplayFramePrint( "rx", &frame );
+                printf( " calls=%" PRIu32 " mul=%" PRIu32 "\n", replay_rx_op.call_cnt, replay_rx_op.mul_cnt );
+            }
+            else if( running == true )
+            {
+                ReplaySensorSet( &frame );
+            }
+        }
+    }
+
+    fclose( log_file );
+
+    if( running == true )
+    {
+        running = HostsimRun( HostsimCycGet() + ( REPLAY_END_US * HOSTSIM_CYC_PER_US ) );
+    }
+
+    if( running == false )
+    {
+        ReplayTimePrint();
+        printf( " stop %s\n", replay_stop_name[ HostsimStopGet() ] );
+    }
+
+    for( isr = 0;
+         isr < HOSTSIM_ISR_NUM_OF;
+         isr++ )
+    {
+        if( replay_isr_stat[ isr ].cnt != 0 )
+        {
+            printf( "isr %s cnt=%" PRIu32 " calls_max=%" PRIu32 " calls_mean=%" PRIu64 " mul_max=%" PRIu32 " mul_mean=%" PRIu64 "\n",
+                    replay_isr_name[ isr ],
+                    replay_isr_stat[ isr ].cnt,
+                    replay_isr_stat[ isr ].call_max,
+                    replay_isr_stat[ isr ].call_sum / replay_isr_stat[ isr ].cnt,
+                    replay_isr_stat[ isr ].mul_max,
+                    replay_isr_stat[ isr ].mul_sum  / replay_isr_stat[ isr ].cnt );
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Print the simulation time (candump -L format).
+////////////////////////////////////////////////////////////////////////////////
+static void ReplayTimePrint ( void )
+{
+    uint64_t time_us = HostsimCycGet() / HOSTSIM_CYC_PER_US;
+
+    printf( "(%" PRIu64 ".%06" PRIu64 ")", time_us / 1000000U, time_us % 1000000U );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Print a frame at the simulation time (without line termination).
+////////////////////////////////////////////////////////////////////////////////
+static void ReplayFramePrint ( const char* dir, const HOSTSIM_CAN_FRAME_S* frame )
+{
+    uint8_t data_idx;
+
+    ReplayTimePrint();
+    printf( ( frame->ide == true ) ? " %s %08" PRIX32 "#" : " %s %03" PRIX32 "#", dir, frame->id );
+
+    for( data_idx = 0;
+         data_idx < frame->dlc;
+         data_idx++ )
+    {
+        printf( "%02X", frame->data[ data_idx ] );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Output a transmitted frame.
+////////////////////////////////////////////////////////////////////////////////
+static void ReplayCanTx ( const HOSTSIM_CAN_FRAME_S* frame )
+{
+    ReplayFramePrint( "tx", frame );
+    printf( "\n" );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Output the PWM duty cycle register.
+////////////////////////////////////////////////////////////////////////////////
+static void ReplayPwm ( uint16_t pdc )
+{
+    ReplayTimePrint();
+    printf( " pwm %u\n", pdc );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Record the operation counts at the start of an interrupt.
+////////////////////////////////////////////////////////////////////////////////
+static void ReplayIsrStart ( HOSTSIM_ISR_E isr )
+{
+    (void) isr;
+
+    HostsimOpCntGet( &replay_op_start );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Accumulate the operation counts of an interrupt.
+////////////////////////////////////////////////////////////////////////////////
+static void ReplayIsrEnd ( HOSTSIM_ISR_E isr )
+{
+    HOSTSIM_OP_CNT_S   op_end;
+    REPLAY_ISR_STAT_S* stat = &replay_isr_stat[ isr ];
+    uint32_t           call_cnt;
+    uint32_t           mul_cnt;
+
+    HostsimOpCntGet( &op_end );
+
+    call_cnt = op_end.call_cnt - replay_op_start.call_cnt;
+    mul_cnt  = op_end.mul_cnt  - replay_op_start.mul_cnt;
+
+    stat->cnt++;
+    stat->call_sum += call_cnt;
+    stat->mul_sum  += mul_cnt;
+
+    if( call_cnt > stat->call_max ) { stat->call_max = call_cnt; }
+    if( mul_cnt  > stat->mul_max  ) { stat->mul_max  = mul_cnt;  }
+
+    if( isr == HOSTSIM_ISR_C1 )
+    {
+        replay_rx_op.call_cnt += call_cnt;
+        replay_rx_op.mul_cnt  += mul_cnt;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Parse a log line - "(sec.usec) iface ID#DATA".
+///
+/// @return true  - line is a data frame.
+///         false - line is not a data frame (e.g. comment or remote frame).
+////////////////////////////////////////////////////////////////////////////////
+static bool ReplayLineParse ( const char* line, uint64_t* time_us, HOSTSIM_CAN_FRAME_S* frame )
+{
+    unsigned long long sec;
+    unsigned long long usec;
+    char     id_str[ 16 ];
+    char     data_str[ 32 ];
+    unsigned byte_val;
+    size_t   data_len;
+    uint8_t  data_idx;
+    bool     valid = false;
+
+    memset( frame, 0, sizeof( *frame ) );
+    data_str[ 0 ] = '\0';
+
+    if( sscanf( line, " (%llu.%llu) %*s %15[0-9A-Fa-f]#%31[0-9A-Fa-f]", &sec, &usec, id_str, data_str ) >= 3 )
+    {
+        data_len = strlen( data_str );
+
+        if( ( data_len % 2U ) == 0 )
+        {
+            *time_us   = ( sec * 1000000U ) + usec;
+            frame->ide = ( strlen( id_str ) > 3U );
+            frame->id  = (uint32_t) strtoul( id_str, NULL, 16 );
+            frame->dlc = (uint8_t) ( ( data_len / 2U ) > 8U ? 8U : ( data_len / 2U ) );
+
+            for( data_idx = 0;
+                 data_idx < frame->dlc;
+                 data_idx++ )
+            {
+                (void) sscanf( &data_str[ data_idx * 2U ], "%2x", &byte_val );
+                frame->data[ data_idx ] = (uint8_t) byte_val;
+            }
+
+            valid = true;
+        }
+    }
+
+    return valid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Set the sensor inputs from a recorded frame of the node.
+////////////////////////////////////////////////////////////////////////////////
+static void ReplaySensorSet ( const HOSTSIM_CAN_FRAME_S* frame )
+{
+    uint16_t data_type = ( frame->id >> 19 ) & 0x3FFU;
+
+    if( ( data_type  == REPLAY_DT_VSENSE_DATA ) &&
+        ( frame->dlc >= 6U                    ) )
+    {
+        HostsimAdcSet( REPLAY_AIN_VSENSE1, ReplayU16Get( &frame->data[ 0 ] ) );
+        HostsimAdcSet( REPLAY_AIN_VSENSE2, ReplayU16Get( &frame->data[ 4 ] ) );
+    }
+    else if( ( data_type  == REPLAY_DT_SERVO_STATUS ) &&
+             ( frame->dlc >= 8U                     ) )
+    {
+        // Note: The annunciated voltage is the Bus Voltage register value
+        // shifted right by one bit (LSB = 4mV -> 1mV); the annunciated
+        // current is the Current register value.
+        HostsimIna219Set( (uint16_t) ( ReplayU16Get( &frame->data[ 4 ] ) << 1 ),
+                          ReplayU16Get( &frame->data[ 6 ] ) );
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return a little-endian 16-bit value of a payload.
+////////////////////////////////////////////////////////////////////////////////
+static uint16_t ReplayU16Get ( const uint8_t data[] )
+{
+    return (uint16_t) ( data[ 0 ] | ( data[ 1 ] << 8 ) );
+}
\ No newline at end of file
@@ -0,0 +1,628 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host simulation check of the firmware's CAN behavior.
+///
+/// The firmware is started on the host simulation (see hostsim.h) and the
+/// following are checked through the simulated CAN bus and PWM output:
+///
+///     - periodic messages (Servo Status, Node Status, Node Version) are
+///       transmitted at their scheduled rates.
+///     - a PWM Servo Command is applied to the PWM duty cycle on reception,
+///       with the duty cycle scaling of every 16-bit PWM command.
+///     - a Configuration Write is acknowledged, and the written value is
+///       returned by a Configuration Read (i.e. NVM page update).
+///     - a position Servo Command is corrected by the written coefficients.
+///     - a burst of Configuration Read Requests exceeding the transmit queue
+///       depth is answered completely and in order of request, without
+///       delaying the Servo Status, and no queued message is dropped (see
+///       the transmit queue Diagnostics Data records).
+///     - a low priority message is transmitted after the next high priority
+///       message, when the completions of a low and a high priority
+///       transmission are serviced by the same CAN interrupt.
+///     - the micro-second and 0.1ms timestamps are continuous through the
+///       roll-over of the 32-bit instruction cycle counter, counted by the
+///       Timer3 interrupt or pending.
+///     - a write of the Node ID performs a software reset.
+///     - the watchdog is cleared throughout.
+///     - the header of every transmitted frame (extended CAN ID of the data
+///       type, transfer type, Node ID and destination; data length of the
+///       message, or of the selection for a Configuration Read Response).
+///
+/// Build and execute with 'make check' (see Makefile).
+///
+/// The exit status is 1 if a check fails.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "hostsim.h"
+#include "can.h"
+#include "tmr.h"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define SIM_NODE_ID             0x7FU   ///< Node ID of the default configuration.
+
+#define SIM_DT_SERVO_CMD        10U     ///< Servo Command data type.
+#define SIM_DT_SERVO_STATUS     20U     ///< Servo Status data type.
+#define SIM_DT_VSENSE_DATA      21U     ///< VSENSE Data data type.
+#define SIM_DT_SERVO_POS        22U     ///< Servo Position data type.
+#define SIM_DT_NODE_STATUS      770U    ///< Node Status data type.
+#define SIM_DT_NODE_VER         771U    ///< Node Version data type.
+#define SIM_DT_DIAG             772U    ///< Node Diagnostics data type.
+#define SIM_DT_CFG_WRITE        800U    ///< Configuration Write Request/Response data type.
+#define SIM_DT_CFG_READ         801U    ///< Configuration Read Request/Response data type.
+
+#define SIM_TSF_REQ             1U      ///< Service Request transfer type.
+#define SIM_TSF_BROADCAST       2U      ///< Message Broadcast transfer type.
+#define SIM_TSF_UNICAST         3U      ///< Message Unicast transfer type.
+#define SIM_TSF_RESP            0U      ///< Service Response transfer type.
+
+#define SIM_FMU_ID              0U      ///< Node ID of the FMU.
+
+#define SIM_DT_NUM_OF           1024U   ///< Number of data types.
+
+#define SIM_DIAG_SEL_TX_DROP    0x84U   ///< Transmit queue drop count record selection.
+#define SIM_DIAG_SEL_TX_HWM     0x85U   ///< Transmit queue high-water mark record selection.
+#define SIM_DIAG_SEL_MARK       0xFFU   ///< Selection of the Diagnostics Data queued by the check.
+
+#define SIM_TX_PRIO_NUM_OF      3U      ///< Number of transmit queues (high, mid, low priority).
+#define SIM_TX_QUEUE_LEN        8U      ///< Number of entries of each transmit queue.
+#define SIM_READ_BURST_LEN      24U     ///< Number of Configuration Read Requests of the burst.
+#define SIM_READ_LOG_LEN        64U     ///< Number of logged Configuration Read Responses.
+
+#define SIM_ROLL_SAMPLE_NUM_OF  40U     ///< Number of timestamp samples through the counter roll-over.
+#define SIM_ROLL_SAMPLE_CYC     777U    ///< Interval of the timestamp samples (instruction cycles).
+#define SIM_ROLL_HOLD_NUM_OF    30U     ///< Number of samples with the Timer3 interrupt held.
+
+/// Header of a transmitted message type.
+typedef struct
+{
+    uint16_t data_type;     ///< Data type.
+    uint8_t  tsf_type;      ///< Transfer type.
+    uint8_t  dest_id;       ///< Destination Node ID.
+    uint8_t  dlc;           ///< Data length (0 - set by the Configuration Read selection).
+
+} SIM_TX_HEADER_S;
+
+/// Time in milli-seconds (LSB = 1 instruction cycle).
+#define SIM_MS( ms )            ( (uint64_t) (ms) * 1000U * HOSTSIM_CYC_PER_US )
+
+/// Evaluate a check, reporting a failure.
+#define SIM_CHECK( cond )                                                       \
+    do                                                                          \
+    {                                                                           \
+        if( !( cond ) )                                                         \
+        {                                                                       \
+            printf( "FAIL line %d: %s\n", __LINE__, #cond );                    \
+            sim_fail_cnt++;                                                     \
+        }                                                                       \
+    } while( 0 )
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Number of failed checks.
+static unsigned sim_fail_cnt;
+
+/// Number of transmitted frames of each data type, and the last frame.
+static unsigned            sim_tx_cnt[ SIM_DT_NUM_OF ];
+static HOSTSIM_CAN_FRAME_S sim_tx_last[ SIM_DT_NUM_OF ];
+
+/// PWM duty cycle register value.
+static uint16_t sim_pdc;
+
+/// Configuration selection of each Configuration Read Response (in order of
+/// transmission, indexed by the response count).
+static uint16_t sim_read_sel[ SIM_READ_LOG_LEN ];
+
+/// Instruction cycle of the last Servo Status, and the maximum interval
+/// between Servo Status messages.
+static uint64_t sim_status_cyc;
+static uint64_t sim_status_gap_max;
+
+/// Number of transmitted frames with the expected header, and with another
+/// header.
+static unsigned sim_hdr_cnt;
+static unsigned sim_hdr_fail_cnt;
+
+/// Last transmit queue Diagnostics Data records (drop count, high-water
+/// mark), and their number.
+static HOSTSIM_CAN_FRAME_S sim_diag_drop;
+static HOSTSIM_CAN_FRAME_S sim_diag_hwm;
+static unsigned            sim_diag_drop_cnt;
+static unsigned            sim_diag_hwm_cnt;
+
+/// Number of Servo Status messages transmitted before the last Diagnostics
+/// Data queued by the check.
+static unsigned sim_mark_status_cnt;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+static void     SimCanTx ( const HOSTSIM_CAN_FRAME_S* frame );
+static void     SimHeaderCheck ( const HOSTSIM_CAN_FRAME_S* frame );
+static uint8_t  SimReadRespLenGet ( uint16_t cfg_sel );
+static void     SimPwm ( uint16_t pdc );
+static void     SimSend ( uint16_t data_type, uint8_t tsf_type, const uint8_t data[], uint8_t dlc );
+static bool     SimRunMs ( uint32_t ms );
+static uint16_t SimU16Get ( const uint8_t data[] );
+static uint32_t SimU32Get ( const uint8_t data[] );
+static void     SimCfgWrite ( uint16_t cfg_sel, int32_t cfg_val );
+static void     SimTickRollCheck ( void );
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+int main ( void )
+{
+    static const HOSTSIM_HOOK_S hook = { SimCanTx, SimPwm, NULL, NULL };
+
+    uint8_t  data[ 8 ];
+    unsigned status_cnt;
+    uint16_t tx_payload[ 4 ];
+    uint32_t pwm_cmd;
+    uint32_t pwm_fail_cnt;
+    unsigned read_cnt;
+    unsigned read_idx;
+    uint8_t  prio;
+
+    SIM_CHECK( HostsimStart( &hook ) == true );
+
+    // Periodic messages - Servo Status at 10ms, Node Status and Version at
+    // 500ms.
+    SIM_CHECK( SimRunMs( 1000 ) == true );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_SERVO_STATUS ] >= 99U  );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_SERVO_STATUS ] <= 101U );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_NODE_STATUS  ] == 2U   );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_NODE_VER     ] == 2U   );
+
+    // Power-on reset is annunciated.
+    SIM_CHECK( SimU16Get( &sim_tx_last[ SIM_DT_NODE_STATUS ].data[ 0 ] ) != 0 );
+
+    // PWM Servo Command (1200us) - applied on reception (PDC3 LSB = 0.4us).
+    memset( data, 0, sizeof( data ) );
+    data[ 2 ] = 1200U & 0xFFU;
+    data[ 3 ] = 1200U >> 8;
+    SimSend( SIM_DT_SERVO_CMD, SIM_TSF_UNICAST, data, 8 );
+    SIM_CHECK( sim_pdc == 3000U );
+
+    // PWM duty cycle scaling (2.5 counts per us) for every PWM Servo Command
+    // - i.e. ( pwm * 5 ) / 2 without overflow of the 16-bit product,
+    // truncated to the 16-bit register.
+    pwm_fail_cnt = 0;
+    for( pwm_cmd = 0;
+         pwm_cmd <= UINT16_MAX;
+         pwm_cmd++ )
+    {
+        data[ 2 ] = (uint8_t) pwm_cmd;
+        data[ 3 ] = (uint8_t) ( pwm_cmd >> 8 );
+        SimSend( SIM_DT_SERVO_CMD, SIM_TSF_UNICAST, data, 8 );
+
+        if( sim_pdc != (uint16_t) ( ( pwm_cmd * 5U ) / 2U ) )
+        {
+            pwm_fail_cnt++;
+        }
+    }
+    SIM_CHECK( pwm_fail_cnt == 0 );
+
+    data[ 2 ] = 1200U & 0xFFU;
+    data[ 3 ] = 1200U >> 8;
+    SimSend( SIM_DT_SERVO_CMD, SIM_TSF_UNICAST, data, 8 );
+
+    // The applied PWM is annunciated in the Servo Status.
+    status_cnt = sim_tx_cnt[ SIM_DT_SERVO_STATUS ];
+    SIM_CHECK( SimRunMs( 20 ) == true );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_SERVO_STATUS ] > status_cnt );
+    SIM_CHECK( SimU16Get( &sim_tx_last[ SIM_DT_SERVO_STATUS ].data[ 2 ] ) == 1200U );
+
+    // Configuration Write of PWM coefficient 0 (1500us, LSB = 0.01us) and
+    // Configuration Read of the written value.
+    SimCfgWrite( 1, 150000 );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_CFG_WRITE ] == 1U );
+    SIM_CHECK( SimU16Get( &sim_tx_last[ SIM_DT_CFG_WRITE ].data[ 0 ] ) == 1U );
+    SIM_CHECK( SimU16Get( &sim_tx_last[ SIM_DT_CFG_WRITE ].data[ 2 ] ) == 0U );
+
+    memset( data, 0, sizeof( data ) );
+    data[ 0 ] = 1;
+    SimSend( SIM_DT_CFG_READ, SIM_TSF_REQ, data, 2 );
+    SIM_CHECK( SimRunMs( 50 ) == true );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_CFG_READ ] == 1U );
+    SIM_CHECK( SimU16Get( &sim_tx_last[ SIM_DT_CFG_READ ].data[ 0 ] ) == 1U );
+    SIM_CHECK( SimU32Get( &sim_tx_last[ SIM_DT_CFG_READ ].data[ 2 ] ) == 150000U );
+
+    // Position Servo Command (0rad) - corrected by the written coefficients
+    // to 1500us.
+    memset( data, 0, sizeof( data ) );
+    data[ 0 ] = 1;
+    SimSend( SIM_DT_SERVO_CMD, SIM_TSF_UNICAST, data, 8 );
+    SIM_CHECK( sim_pdc == 3750U );
+
+    // Burst of Configuration Read Requests exceeding the low priority
+    // transmit queue depth - requests are serviced only as responses can be
+    // queued, so that all are answered in order of request, while the high
+    // priority Servo Status is transmitted at its rate.
+    read_cnt           = sim_tx_cnt[ SIM_DT_CFG_READ ];
+    sim_status_gap_max = 0;
+
+    for( read_idx = 0;
+         read_idx < SIM_READ_BURST_LEN;
+         read_idx++ )
+    {
+        memset( data, 0, sizeof( data ) );
+        data[ 0 ] = (uint8_t) read_idx;
+        SimSend( SIM_DT_CFG_READ, SIM_TSF_REQ, data, 2 );
+    }
+
+    SIM_CHECK( SimRunMs( 100 ) == true );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_CFG_READ ] == read_cnt + SIM_READ_BURST_LEN );
+
+    for( read_idx = 0;
+         read_idx < SIM_READ_BURST_LEN;
+         read_idx++ )
+    {
+        SIM_CHECK( sim_read_sel[ read_cnt + read_idx ] == read_idx );
+    }
+
+    SIM_CHECK( sim_status_gap_max <= SIM_MS( 11 ) );
+
+    // No message of any priority was dropped by its transmit queue, and the
+    // low priority queue was filled (i.e. the burst was held by the queue).
+    sim_diag_drop_cnt = 0;
+    sim_diag_hwm_cnt  = 0;
+    SIM_CHECK( SimRunMs( 2000 ) == true );
+    SIM_CHECK( sim_diag_drop_cnt != 0 );
+    SIM_CHECK( sim_diag_hwm_cnt  != 0 );
+
+    for( prio = 0;
+         prio < SIM_TX_PRIO_NUM_OF;
+         prio++ )
+    {
+        SIM_CHECK( SimU16Get( &sim_diag_drop.data[ 2U + ( 2U * prio ) ] ) == 0U );
+        SIM_CHECK( SimU16Get( &sim_diag_hwm.data[ 2U + ( 2U * prio ) ] ) <= SIM_TX_QUEUE_LEN );
+    }
+
+    SIM_CHECK( SimU16Get( &sim_diag_hwm.data[ 6 ] ) == SIM_TX_QUEUE_LEN );
+
+    printf( "simcheck: transmit queue high-water mark high %u, mid %u, low %u; Servo Status interval max %.2fms\n",
+            SimU16Get( &sim_diag_hwm.data[ 2 ] ),
+            SimU16Get( &sim_diag_hwm.data[ 4 ] ),
+            SimU16Get( &sim_diag_hwm.data[ 6 ] ),
+            (double) sim_status_gap_max / SIM_MS( 1 ) );
+
+    // Configuration Read of the CAN bit rate and auto-baud enable (1-byte
+    // values, as the Node ID, PWM calibration type and breakpoint count of
+    // the burst - see SimHeaderCheck).
+    for( read_idx = 53;
+         read_idx <= 54U;
+         read_idx++ )
+    {
+        memset( data, 0, sizeof( data ) );
+        data[ 0 ] = (uint8_t) read_idx;
+        SimSend( SIM_DT_CFG_READ, SIM_TSF_REQ, data, 2 );
+    }
+
+    SIM_CHECK( SimRunMs( 50 ) == true );
+    SIM_CHECK( sim_tx_last[ SIM_DT_CFG_READ ].dlc == 3U );
+
+    // Completion of a low and a high priority transmission serviced by the
+    // same CAN interrupt (i.e. the interrupt is held by a higher priority
+    // thread), with the low priority buffer below the high priority buffer.
+    // The next low priority message is transmitted after the next high
+    // priority message, not after the high priority queue is emptied.
+    //
+    // Note: The messages are queued between software cycles (i.e. on an idle
+    // bus), as by the software cycle.
+    //
+    SIM_CHECK( HostsimRun( ( ( HostsimCycGet() / SIM_MS( 10 ) ) * SIM_MS( 10 ) ) + SIM_MS( 15 ) ) == true );
+
+    memset( tx_payload, 0, sizeof( tx_payload ) );
+    status_cnt = sim_tx_cnt[ SIM_DT_SERVO_STATUS ];
+
+    tx_payload[ 0 ] = SIM_DIAG_SEL_MARK;
+    CANTxSet( CAN_TX_MSG_DIAG_DATA, tx_payload );
+    SIM_CHECK( HostsimRun( HostsimCycGet() ) == true );
+
+    tx_payload[ 0 ] = 0;
+    CANTxSet( CAN_TX_MSG_SERVO_STATUS, tx_payload );
+    SIM_CHECK( HostsimRun( HostsimCycGet() ) == true );
+
+    HostsimIsrHold( HOSTSIM_ISR_C1, true );
+    CANTxSet( CAN_TX_MSG_SERVO_STATUS, tx_payload );
+    CANTxSet( CAN_TX_MSG_SERVO_STATUS, tx_payload );
+    tx_payload[ 0 ] = SIM_DIAG_SEL_MARK;
+    CANTxSet( CAN_TX_MSG_DIAG_DATA, tx_payload );
+    SIM_CHECK( SimRunMs( 1 ) == true );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_SERVO_STATUS ] == status_cnt + 1U );
+
+    HostsimIsrHold( HOSTSIM_ISR_C1, false );
+    SIM_CHECK( SimRunMs( 1 ) == true );
+    SIM_CHECK( sim_tx_cnt[ SIM_DT_SERVO_STATUS ] == status_cnt + 3U );
+    SIM_CHECK( sim_mark_status_cnt == status_cnt + 2U );
+
+    // Watchdog is cleared over a long execution.
+    SIM_CHECK( SimRunMs( 10000 ) == true );
+
+    // Every frame transmitted so far had the header of its message type.
+    SIM_CHECK( sim_hdr_cnt      != 0  );
+    SIM_CHECK( sim_hdr_fail_cnt == 0U );
+    printf( "simcheck: %u transmitted frame header(s) checked\n", sim_hdr_cnt + sim_hdr_fail_cnt );
+
+    // Timestamps through the roll-over of the 32-bit counter.
+    SimTickRollCheck();
+
+    // Write of the Node ID performs a software reset.
+    SimCfgWrite( 0, 0x10 );
+    SIM_CHECK( HostsimStopGet() == HOSTSIM_STOP_RESET );
+
+    printf( "simcheck: %u failure(s)\n", sim_fail_cnt );
+
+    return ( sim_fail_cnt == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Record a transmitted frame by its data type.
+////////////////////////////////////////////////////////////////////////////////
+static void SimCanTx ( const HOSTSIM_CAN_FRAME_S* frame )
+{
+    uint16_t data_type = ( frame->id >> 19 ) & 0x3FFU;
+
+    SimHeaderCheck( frame );
+
+    if( ( data_type == SIM_DT_CFG_READ ) &&
+        ( sim_tx_cnt[ data_type ] < SIM_READ_LOG_LEN ) )
+    {
+        sim_read_sel[ sim_tx_cnt[ data_type ] ] = SimU16Get( &frame->data[ 0 ] );
+    }
+    else if( data_type == SIM_DT_SERVO_STATUS )
+    {
+        if( ( sim_tx_cnt[ data_type ] != 0 ) &&
+            ( HostsimCycGet() - sim_status_cyc > sim_status_gap_max ) )
+        {
+            sim_status_gap_max = HostsimCycGet() - sim_status_cyc;
+        }
+
+        sim_status_cyc = HostsimCycGet();
+    }
+    else if( data_type == SIM_DT_DIAG )
+    {
+        if( SimU16Get( &frame->data[ 0 ] ) == SIM_DIAG_SEL_TX_DROP )
+        {
+            sim_diag_drop = *frame;
+            sim_diag_drop_cnt++;
+        }
+        else if( SimU16Get( &frame->data[ 0 ] ) == SIM_DIAG_SEL_TX_HWM )
+        {
+            sim_diag_hwm = *frame;
+            sim_diag_hwm_cnt++;
+        }
+        else if( SimU16Get( &frame->data[ 0 ] ) == SIM_DIAG_SEL_MARK )
+        {
+            sim_mark_status_cnt = sim_tx_cnt[ SIM_DT_SERVO_STATUS ];
+        }
+    }
+
+    sim_tx_cnt[ data_type ]++;
+    sim_tx_last[ data_type ] = *frame;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Check the header of a transmitted frame against that of its
+///         message type, reporting the first differing frames.
+////////////////////////////////////////////////////////////////////////////////
+static void SimHeaderCheck ( const HOSTSIM_CAN_FRAME_S* frame )
+{
+    static const SIM_TX_HEADER_S tx_header[] =
+    {
+        { SIM_DT_SERVO_STATUS, SIM_TSF_BROADCAST, 0,           8 },
+        { SIM_DT_VSENSE_DATA,  SIM_TSF_BROADCAST, 0,           8 },
+        { SIM_DT_SERVO_POS,    SIM_TSF_BROADCAST, 0,           4 },
+        { SIM_DT_NODE_STATUS,  SIM_TSF_BROADCAST, 0,           4 },
+        { SIM_DT_NODE_VER,     SIM_TSF_BROADCAST, 0,           8 },
+        { SIM_DT_DIAG,         SIM_TSF_BROADCAST, 0,           8 },
+        { SIM_DT_CFG_WRITE,    SIM_TSF_RESP,      SIM_FMU_ID,  4 },
+        { SIM_DT_CFG_READ,     SIM_TSF_RESP,      SIM_FMU_ID,  0 },
+    };
+
+    uint16_t data_type = ( frame->id >> 19 ) & 0x3FFU;
+    uint32_t id;
+    uint8_t  dlc;
+    uint8_t  hdr_idx;
+    bool     hdr_valid = false;
+
+    for( hdr_idx = 0;
+         hdr_idx < sizeof( tx_header ) / sizeof( tx_header[ 0 ] );
+         hdr_idx++ )
+    {
+        if( tx_header[ hdr_idx ].data_type == data_type )
+        {
+            id  = ( (uint32_t) tx_header[ hdr_idx ].data_type << 19 ) |
+                  ( (uint32_t) tx_header[ hdr_idx ].tsf_type  << 17 ) |
+                  ( (uint32_t) SIM_NODE_ID << 10 ) |
+                  tx_header[ hdr_idx ].dest_id;
+            dlc = ( tx_header[ hdr_idx ].dlc != 0 ) ? tx_header[ hdr_idx ].dlc :
+                                                      SimReadRespLenGet( SimU16Get( &frame->data[ 0 ] ) );
+
+            hdr_valid = ( frame->ide == true ) &&
+                        ( frame->id  == id   ) &&
+                        ( frame->dlc == dlc  );
+        }
+    }
+
+    if( hdr_valid == true )
+    {
+        sim_hdr_cnt++;
+    }
+    else
+    {
+        if( sim_hdr_fail_cnt < 5U )
+        {
+            printf( "FAIL header: ID %08lX IDE %d DLC %u\n",
+                    (unsigned long) frame->id, (int) frame->ide, (unsigned) frame->dlc );
+        }
+
+        sim_hdr_fail_cnt++;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the data length of a Configuration Read Response - the
+///         selection (2 bytes) and its value (1 byte for the Node ID, PWM
+///         calibration type, PWM breakpoint count, CAN bit rate and auto-baud
+///         enable, otherwise 4 bytes).
+////////////////////////////////////////////////////////////////////////////////
+static uint8_t SimReadRespLenGet ( uint16_t cfg_sel )
+{
+    return ( ( cfg_sel == 0  ) ||
+             ( cfg_sel == 19 ) ||
+             ( cfg_sel == 20 ) ||
+             ( cfg_sel == 53 ) ||
+             ( cfg_sel == 54 ) ) ? 3U : 6U;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Record the PWM duty cycle register.
+////////////////////////////////////////////////////////////////////////////////
+static void SimPwm ( uint16_t pdc )
+{
+    sim_pdc = pdc;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Send a frame from the FMU (Node ID 0) to the node, and execute
+///         until its reception is processed by the CAN interrupt.
+////////////////////////////////////////////////////////////////////////////////
+static void SimSend ( uint16_t data_type, uint8_t tsf_type, const uint8_t data[], uint8_t dlc )
+{
+    HOSTSIM_CAN_FRAME_S frame;
+
+    frame.id  = ( (uint32_t) data_type << 19 ) | ( (uint32_t) tsf_type << 17 ) | SIM_NODE_ID;
+    frame.ide = true;
+    frame.dlc = dlc;
+    memset( frame.data, 0, sizeof( frame.data ) );
+    memcpy( frame.data, data, dlc );
+
+    HostsimCanRx( &frame );
+
+    (void) HostsimRun( HostsimCycGet() + 1U );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Execute the simulation for a number of milli-seconds.
+////////////////////////////////////////////////////////////////////////////////
+static bool SimRunMs ( uint32_t ms )
+{
+    return HostsimRun( HostsimCycGet() + SIM_MS( ms ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return a little-endian 16-bit value of a payload.
+////////////////////////////////////////////////////////////////////////////////
+static uint16_t SimU16Get ( const uint8_t data[] )
+{
+    return (uint16_t) ( data[ 0 ] | ( data[ 1 ] << 8 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return a little-endian 32-bit value of a payload.
+////////////////////////////////////////////////////////////////////////////////
+static uint32_t SimU32Get ( const uint8_t data[] )
+{
+    return (uint32_t) SimU16Get( &data[ 0 ] ) | ( (uint32_t) SimU16Get( &data[ 2 ] ) << 16 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Send a Configuration Write Request, and execute until processed.
+////////////////////////////////////////////////////////////////////////////////
+static void SimCfgWrite ( uint16_t cfg_sel, int32_t cfg_val )
+{
+    uint8_t data[ 8 ];
+
+    memset( data, 0, sizeof( data ) );
+    data[ 0 ] = (uint8_t) cfg_sel;
+    data[ 1 ] = (uint8_t) ( cfg_sel >> 8 );
+    data[ 2 ] = (uint8_t) cfg_val;
+    data[ 3 ] = (uint8_t) ( (uint32_t) cfg_val >> 8 );
+    data[ 4 ] = (uint8_t) ( (uint32_t) cfg_val >> 16 );
+    data[ 5 ] = (uint8_t) ( (uint32_t) cfg_val >> 24 );
+
+    SimSend( SIM_DT_CFG_WRITE, SIM_TSF_REQ, data, 6 );
+
+    (void) SimRunMs( 50 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Check the micro-second and 0.1ms timestamps (TMRUsGet,
+///         TMR2p1msGet) through the roll-over of the 32-bit instruction cycle
+///         counter (~214.7s).
+///
+/// The timestamps are sampled from 1ms before the roll-over, and compared
+/// with the simulation time since the start of the counter, divided by
+/// their periods.  The Timer3 interrupt is held for the first samples after
+/// the roll-over, so that the roll-over is identified as pending, and then
+/// counted by the interrupt.
+///
+/// @note   Each read of the counter advances the simulation time by one
+///         instruction cycle (see HostsimTmr2Get).  Each timestamp reads the
+///         counter once.
+////////////////////////////////////////////////////////////////////////////////
+static void SimTickRollCheck ( void )
+{
+    uint64_t cyc_base;
+    uint64_t cyc;
+    uint32_t fail_cnt = 0;
+    uint16_t sample_idx;
+
+    SIM_CHECK( HostsimRun( HostsimCycGet() + ( 0U - TMRTickGet() ) - SIM_MS( 1 ) ) == true );
+
+    // Simulation time at which the counter started (i.e. the roll-over
+    // count is 0).
+    cyc      = HostsimCycGet();
+    cyc_base = ( cyc + 1U ) - TMRTickGet();
+
+    HostsimIsrHold( HOSTSIM_ISR_T3, true );
+
+    for( sample_idx = 0;
+         sample_idx < SIM_ROLL_SAMPLE_NUM_OF;
+         sample_idx++ )
+    {
+        if( sample_idx == SIM_ROLL_HOLD_NUM_OF )
+        {
+            HostsimIsrHold( HOSTSIM_ISR_T3, false );
+        }
+
+        SIM_CHECK( HostsimRun( HostsimCycGet() + SIM_ROLL_SAMPLE_CYC ) == true );
+
+        cyc = HostsimCycGet() - cyc_base;
+
+        if( ( TMRUsGet()    != (uint32_t) ( ( cyc + 1U ) / 20U   ) ) ||
+            ( TMR2p1msGet() != (uint16_t) ( ( cyc + 2U ) / 2000U ) ) )
+        {
+            fail_cnt++;
+        }
+    }
+
+    SIM_CHECK( fail_cnt == 0 );
+
+    // The counter rolled-over during the samples.
+    SIM_CHECK( cyc >> 32 == 1U );
+}
\ No newline at end of file
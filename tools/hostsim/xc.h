@@ -0,0 +1,347 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host build substitute of the XC16 device header.
+///
+/// Each Special Function Register (SFR) used by the firmware is defined as
+/// a 16-bit union of the register value and its bit-fields (in the order of
+/// the device datasheet), so that the firmware modules compile unmodified
+/// on the host.  Registers are plain memory, except those with hardware
+/// behavior the firmware waits on or samples (timers, ADC conversion, ECAN
+/// operating mode and FIFO pointer), which are accessed through a function
+/// of the simulation model (see hostsim.c).
+///
+/// @note   The register storage is defined by the simulation model, which
+///         includes this file with HOSTSIM_SFR_DEFINE set.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef HOSTSIM_XC_H_
+#define HOSTSIM_XC_H_
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <stdint.h>
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#ifdef HOSTSIM_SFR_DEFINE
+#define HOSTSIM_SFR_STORAGE
+#else
+#define HOSTSIM_SFR_STORAGE     extern
+#endif
+
+/// Declare a register - the value (NAME) and its bit-fields (NAMEbits).
+#define HOSTSIM_SFR( name, ... )                                                \
+    typedef union                                                               \
+    {                                                                           \
+        uint16_t reg;                                                           \
+        struct { uint16_t __VA_ARGS__; } bits;                                  \
+    } HOSTSIM_##name##_U;                                                       \
+    HOSTSIM_SFR_STORAGE volatile HOSTSIM_##name##_U hostsim_##name
+
+/// Declare a register without bit-fields.
+#define HOSTSIM_SFR_REG( name )                                                 \
+    HOSTSIM_SFR_STORAGE volatile uint16_t hostsim_##name
+
+/// Control bits of a pair of ECAN transmit buffers (C1TRmnCON).
+#define HOSTSIM_SFR_TRCON( name, m, n )                                         \
+    HOSTSIM_SFR( name, TX##m##PRI:2, RTREN##m:1, TXREQ##m:1, TXERR##m:1,        \
+                       TXLARB##m:1, TXABT##m:1, TXEN##m:1,                      \
+                       TX##n##PRI:2, RTREN##n:1, TXREQ##n:1, TXERR##n:1,        \
+                       TXLARB##n:1, TXABT##n:1, TXEN##n:1 )
+
+// *****************************************************************************
+// ************************** Declarations *************************************
+// *****************************************************************************
+
+// ---- ADC --------------------------------------------------------------------
+HOSTSIM_SFR( AD1CON1,   DONE:1, SAMP:1, ASAM:1, SIMSAM:1, SSRCG:1, SSRC:3, FORM:2, AD12B:1, :1, ADDMABM:1, ADSIDL:1, :1, ADON:1 );
+HOSTSIM_SFR( AD1CON2,   ALTS:1, BUFM:1, SMPI:5, BUFS:1, CHPS:2, CSCNA:1, :2, VCFG:3 );
+HOSTSIM_SFR( AD1CON3,   ADCS:8, SAMC:5, :2, ADRC:1 );
+HOSTSIM_SFR( AD1CON4,   DMABL:3, :5, ADDMAEN:1, :7 );
+HOSTSIM_SFR( AD1CHS0,   CH0SA:6, :1, CH0NA:1, CH0SB:6, :1, CH0NB:1 );
+HOSTSIM_SFR( AD1CHS123, :8, CH123SB0:1, CH123NB0:1, CH123NB1:1, CH123SB1:1, CH123SB2:1, :3 );
+HOSTSIM_SFR_REG( ADC1BUF0 );
+
+// ---- I/O ports --------------------------------------------------------------
+HOSTSIM_SFR( ANSELA,    ANSA0:1, ANSA1:1, :2, ANSA4:1, :11 );
+HOSTSIM_SFR( ANSELB,    ANSB0:1, ANSB1:1, :5, ANSB7:1, ANSB8:1, ANSB9:1, :6 );
+HOSTSIM_SFR( PORTA,     RA0:1, RA1:1, RA2:1, RA3:1, RA4:1, :11 );
+HOSTSIM_SFR( PORTB,     RB0:1, RB1:1, RB2:1, RB3:1, RB4:1, RB5:1, RB6:1, RB7:1, RB8:1, RB9:1, RB10:1, RB11:1, RB12:1, RB13:1, RB14:1, RB15:1 );
+HOSTSIM_SFR( TRISA,     TRISA0:1, TRISA1:1, TRISA2:1, TRISA3:1, TRISA4:1, :11 );
+HOSTSIM_SFR( TRISB,     TRISB0:1, TRISB1:1, TRISB2:1, TRISB3:1, TRISB4:1, TRISB5:1, TRISB6:1, TRISB7:1, TRISB8:1, TRISB9:1, TRISB10:1, TRISB11:1, TRISB12:1, TRISB13:1, TRISB14:1, TRISB15:1 );
+HOSTSIM_SFR( RPINR26,   C1RXR:7, :9 );
+HOSTSIM_SFR( RPOR1,     RP36R:6, :10 );
+
+// ---- ECAN -------------------------------------------------------------------
+HOSTSIM_SFR( C1CTRL1,   WIN:1, :2, CANCAP:1, :1, OPMODE:3, REQOP:3, CANCKS:1, ABAT:1, CSIDL:1, :2 );
+HOSTSIM_SFR( C1CTRL2,   DNCNT:5, :11 );
+HOSTSIM_SFR( C1CFG1,    BRP:6, SJW:2, :8 );
+HOSTSIM_SFR( C1CFG2,    PRSEG:3, SEG1PH:3, SAM:1, SEG2PHTS:1, SEG2PH:3, :3, WAKFIL:1, :1 );
+HOSTSIM_SFR( C1FCTRL,   FSA:5, :8, DMABS:3 );
+HOSTSIM_SFR( C1FIFO,    FNRB:6, :2, FBP:6, :2 );
+HOSTSIM_SFR( C1INTE,    TBIE:1, RBIE:1, RBOVIE:1, FIFOIE:1, :1, ERRIE:1, WAKIE:1, IVRIE:1, :8 );
+HOSTSIM_SFR( C1INTF,    TBIF:1, RBIF:1, RBOVIF:1, FIFOIF:1, :1, ERRIF:1, WAKIF:1, IVRIF:1, EWARN:1, RXWAR:1, TXWAR:1, RXBP:1, TXBP:1, TXBO:1, :2 );
+HOSTSIM_SFR( C1FEN1,    FLTEN0:1, FLTEN1:1, FLTEN2:1, FLTEN3:1, FLTEN4:1, FLTEN5:1, FLTEN6:1, FLTEN7:1, FLTEN8:1, FLTEN9:1, FLTEN10:1, FLTEN11:1, FLTEN12:1, FLTEN13:1, FLTEN14:1, FLTEN15:1 );
+HOSTSIM_SFR( C1FMSKSEL1, F0MSK:2, F1MSK:2, F2MSK:2, F3MSK:2, F4MSK:2, F5MSK:2, F6MSK:2, F7MSK:2 );
+HOSTSIM_SFR( C1BUFPNT1, F0BP:4, F1BP:4, F2BP:4, F3BP:4 );
+HOSTSIM_SFR( C1BUFPNT2, F4BP:4, F5BP:4, F6BP:4, F7BP:4 );
+HOSTSIM_SFR( C1RXF0SID, EID:2, :1, EXIDE:1, :1, SID:11 );
+HOSTSIM_SFR( C1RXF1SID, EID:2, :1, EXIDE:1, :1, SID:11 );
+HOSTSIM_SFR( C1RXF2SID, EID:2, :1, EXIDE:1, :1, SID:11 );
+HOSTSIM_SFR( C1RXF3SID, EID:2, :1, EXIDE:1, :1, SID:11 );
+HOSTSIM_SFR( C1RXF4SID, EID:2, :1, EXIDE:1, :1, SID:11 );
+HOSTSIM_SFR( C1RXF5SID, EID:2, :1, EXIDE:1, :1, SID:11 );
+HOSTSIM_SFR( C1RXM0SID, EID:2, :1, MIDE:1, :1, SID:11 );
+HOSTSIM_SFR( C1RXM1SID, EID:2, :1, MIDE:1, :1, SID:11 );
+HOSTSIM_SFR_REG( C1RXF0EID );
+HOSTSIM_SFR_REG( C1RXF1EID );
+HOSTSIM_SFR_REG( C1RXF2EID );
+HOSTSIM_SFR_REG( C1RXF3EID );
+HOSTSIM_SFR_REG( C1RXF4EID );
+HOSTSIM_SFR_REG( C1RXF5EID );
+HOSTSIM_SFR_REG( C1RXM0EID );
+HOSTSIM_SFR_REG( C1RXM1EID );
+HOSTSIM_SFR_REG( C1RXFUL1 );
+HOSTSIM_SFR_REG( C1RXOVF1 );
+HOSTSIM_SFR_REG( C1RXD );
+HOSTSIM_SFR_REG( C1TXD );
+HOSTSIM_SFR_TRCON( C1TR01CON, 0, 1 );
+HOSTSIM_SFR_TRCON( C1TR23CON, 2, 3 );
+HOSTSIM_SFR_TRCON( C1TR45CON, 4, 5 );
+HOSTSIM_SFR_TRCON( C1TR67CON, 6, 7 );
+
+// ---- DMA --------------------------------------------------------------------
+// Note: The address registers are 32-bit, so that the host address of the
+// message buffers is retained (the tools are linked as position-dependent
+// executables, which places static data within the lower 4GB).
+HOSTSIM_SFR( DMA0CON,   MODE:2, :2, AMODE:2, :5, NULLW:1, HALF:1, DIR:1, SIZE:1, CHEN:1 );
+HOSTSIM_SFR( DMA0REQ,   IRQSEL:8, :7, FORCE:1 );
+HOSTSIM_SFR( DMA0CNT,   CNT:14, :2 );
+HOSTSIM_SFR( DMA1CON,   MODE:2, :2, AMODE:2, :5, NULLW:1, HALF:1, DIR:1, SIZE:1, CHEN:1 );
+HOSTSIM_SFR( DMA1REQ,   IRQSEL:8, :7, FORCE:1 );
+HOSTSIM_SFR( DMA1CNT,   CNT:14, :2 );
+HOSTSIM_SFR_REG( DMA0STAH );
+HOSTSIM_SFR_REG( DMA1STAH );
+HOSTSIM_SFR_STORAGE volatile uint32_t hostsim_DMA0STAL;
+HOSTSIM_SFR_STORAGE volatile uint32_t hostsim_DMA1STAL;
+HOSTSIM_SFR_STORAGE volatile uint32_t hostsim_DMA0PAD;
+HOSTSIM_SFR_STORAGE volatile uint32_t hostsim_DMA1PAD;
+
+// ---- Interrupts -------------------------------------------------------------
+HOSTSIM_SFR( INTCON2,   :15, GIE:1 );
+HOSTSIM_SFR( IEC0,      :3, T1IE:1, :3, T2IE:1, T3IE:1, :7 );
+HOSTSIM_SFR( IFS0,      :3, T1IF:1, :3, T2IF:1, T3IF:1, :7 );
+HOSTSIM_SFR( IEC1,      :11, T4IE:1, :4 );
+HOSTSIM_SFR( IFS1,      :11, T4IF:1, :4 );
+HOSTSIM_SFR( IEC2,      :3, C1IE:1, :12 );
+HOSTSIM_SFR( IFS2,      :3, C1IF:1, :12 );
+HOSTSIM_SFR( IPC0,      :12, T1IP:3, :1 );
+HOSTSIM_SFR( IPC2,      T3IP:3, :13 );
+HOSTSIM_SFR( IPC6,      :12, T4IP:3, :1 );
+HOSTSIM_SFR( IPC8,      :4, C1IP:3, :9 );
+
+// ---- Oscillator and reset ---------------------------------------------------
+HOSTSIM_SFR( CLKDIV,    PLLPRE:5, :1, PLLPOST:2, FRCDIV:3, DOZEN:1, DOZE:3, ROI:1 );
+HOSTSIM_SFR( PLLFBD,    PLLDIV:9, :7 );
+HOSTSIM_SFR( OSCCON,    :5, LOCK:1, :10 );
+HOSTSIM_SFR( RCON,      POR:1, BOR:1, IDLE:1, SLEEP:1, WDTO:1, SWDTEN:1, SWR:1, EXTR:1, VREGS:1, CM:1, :1, VREGSF:1, :2, IOPUWR:1, TRAPR:1 );
+
+// ---- PWM --------------------------------------------------------------------
+HOSTSIM_SFR( PTCON,     SEVTPS:4, SYNCSRC:3, SYNCEN:1, SYNCOEN:1, SYNCPOL:1, EIPU:1, SEIEN:1, SESTAT:1, PTSIDL:1, :1, PTEN:1 );
+HOSTSIM_SFR( PTCON2,    PCLKDIV:3, :13 );
+HOSTSIM_SFR( CHOP,      CHOPCLK:10, :5, CHPCLKEN:1 );
+HOSTSIM_SFR( PWMCON3,   IUE:1, XPRES:1, CAM:1, MTBS:1, :1, DTCP:1, DTC:2, MDCS:1, ITB:1, TRGIEN:1, CLIEN:1, FLTIEN:1, TRGSTAT:1, CLSTAT:1, FLTSTAT:1 );
+HOSTSIM_SFR( AUXCON3,   CHOPLEN:1, CHOPHEN:1, :14 );
+HOSTSIM_SFR_REG( IOCON3 );
+HOSTSIM_SFR_REG( FCLCON3 );
+HOSTSIM_SFR_REG( PHASE3 );
+HOSTSIM_SFR_REG( PDC3 );
+
+// ---- Timers -----------------------------------------------------------------
+HOSTSIM_SFR( T1CON,     :1, TCS:1, TSYNC:1, :1, TCKPS:2, TGATE:1, :6, TSIDL:1, :1, TON:1 );
+HOSTSIM_SFR( T2CON,     :1, TCS:1, :1, T32:1, TCKPS:2, TGATE:1, :6, TSIDL:1, :1, TON:1 );
+HOSTSIM_SFR( T3CON,     :1, TCS:1, :2, TCKPS:2, TGATE:1, :6, TSIDL:1, :1, TON:1 );
+HOSTSIM_SFR( T4CON,     :1, TCS:1, :1, T32:1, TCKPS:2, TGATE:1, :6, TSIDL:1, :1, TON:1 );
+HOSTSIM_SFR_REG( TMR1 );
+HOSTSIM_SFR_REG( TMR2 );
+HOSTSIM_SFR_REG( TMR3 );
+HOSTSIM_SFR_REG( TMR3HLD );
+HOSTSIM_SFR_REG( TMR4 );
+HOSTSIM_SFR_REG( PR1 );
+HOSTSIM_SFR_REG( PR2 );
+HOSTSIM_SFR_REG( PR3 );
+HOSTSIM_SFR_REG( PR4 );
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+// Register accesses with hardware behavior (see hostsim.c).
+volatile HOSTSIM_AD1CON1_U* HostsimAd1con1Get ( void );
+volatile HOSTSIM_C1CTRL1_U* HostsimC1ctrl1Get ( void );
+volatile HOSTSIM_C1FIFO_U*  HostsimC1fifoGet  ( void );
+volatile uint16_t*          HostsimTmr1Get    ( void );
+volatile uint16_t*          HostsimTmr2Get    ( void );
+volatile uint16_t*          HostsimTmr4Get    ( void );
+
+// Instruction and compiler built-in substitutes (see hostsim.c).
+void     HostsimWdtClear ( void );
+int32_t  HostsimMulss ( int16_t a, int16_t b );
+int32_t  HostsimMulsu ( int16_t a, uint16_t b );
+uint32_t HostsimMuluu ( uint16_t a, uint16_t b );
+
+// *****************************************************************************
+// ************************** Register Names ***********************************
+// *****************************************************************************
+
+#define AD1CON1bits     ( HostsimAd1con1Get()->bits )
+#define AD1CON2bits     hostsim_AD1CON2.bits
+#define AD1CON3bits     hostsim_AD1CON3.bits
+#define AD1CON4bits     hostsim_AD1CON4.bits
+#define AD1CHS0bits     hostsim_AD1CHS0.bits
+#define AD1CHS123bits   hostsim_AD1CHS123.bits
+#define ADC1BUF0        hostsim_ADC1BUF0
+
+#define ANSELAbits      hostsim_ANSELA.bits
+#define ANSELBbits      hostsim_ANSELB.bits
+#define PORTAbits       hostsim_PORTA.bits
+#define PORTBbits       hostsim_PORTB.bits
+#define TRISAbits       hostsim_TRISA.bits
+#define TRISBbits       hostsim_TRISB.bits
+#define RPINR26bits     hostsim_RPINR26.bits
+#define RPOR1bits       hostsim_RPOR1.bits
+
+#define C1CTRL1bits     ( HostsimC1ctrl1Get()->bits )
+#define C1CTRL2bits     hostsim_C1CTRL2.bits
+#define C1CFG1bits      hostsim_C1CFG1.bits
+#define C1CFG2bits      hostsim_C1CFG2.bits
+#define C1FCTRLbits     hostsim_C1FCTRL.bits
+#define C1FIFObits      ( HostsimC1fifoGet()->bits )
+#define C1INTEbits      hostsim_C1INTE.bits
+#define C1INTFbits      hostsim_C1INTF.bits
+#define C1FEN1          hostsim_C1FEN1.reg
+#define C1FEN1bits      hostsim_C1FEN1.bits
+#define C1FMSKSEL1bits  hostsim_C1FMSKSEL1.bits
+#define C1BUFPNT1bits   hostsim_C1BUFPNT1.bits
+#define C1BUFPNT2bits   hostsim_C1BUFPNT2.bits
+#define C1RXF0SIDbits   hostsim_C1RXF0SID.bits
+#define C1RXF1SIDbits   hostsim_C1RXF1SID.bits
+#define C1RXF2SIDbits   hostsim_C1RXF2SID.bits
+#define C1RXF3SIDbits   hostsim_C1RXF3SID.bits
+#define C1RXF4SIDbits   hostsim_C1RXF4SID.bits
+#define C1RXF5SIDbits   hostsim_C1RXF5SID.bits
+#define C1RXM0SIDbits   hostsim_C1RXM0SID.bits
+#define C1RXM1SID       hostsim_C1RXM1SID.reg
+#define C1RXF0EID       hostsim_C1RXF0EID
+#define C1RXF1EID       hostsim_C1RXF1EID
+#define C1RXF2EID       hostsim_C1RXF2EID
+#define C1RXF3EID       hostsim_C1RXF3EID
+#define C1RXF4EID       hostsim_C1RXF4EID
+#define C1RXF5EID       hostsim_C1RXF5EID
+#define C1RXM0EID       hostsim_C1RXM0EID
+#define C1RXM1EID       hostsim_C1RXM1EID
+#define C1RXFUL1        hostsim_C1RXFUL1
+#define C1RXOVF1        hostsim_C1RXOVF1
+#define C1RXD           hostsim_C1RXD
+#define C1TXD           hostsim_C1TXD
+#define C1TR01CON       hostsim_C1TR01CON.reg
+#define C1TR01CONbits   hostsim_C1TR01CON.bits
+#define C1TR23CON       hostsim_C1TR23CON.reg
+#define C1TR23CONbits   hostsim_C1TR23CON.bits
+#define C1TR45CON       hostsim_C1TR45CON.reg
+#define C1TR45CONbits   hostsim_C1TR45CON.bits
+#define C1TR67CON       hostsim_C1TR67CON.reg
+#define C1TR67CONbits   hostsim_C1TR67CON.bits
+
+#define DMA0CONbits     hostsim_DMA0CON.bits
+#define DMA0REQbits     hostsim_DMA0REQ.bits
+#define DMA0CNTbits     hostsim_DMA0CNT.bits
+#define DMA0STAL        hostsim_DMA0STAL
+#define DMA0STAH        hostsim_DMA0STAH
+#define DMA0PAD         hostsim_DMA0PAD
+#define DMA1CONbits     hostsim_DMA1CON.bits
+#define DMA1REQbits     hostsim_DMA1REQ.bits
+#define DMA1CNTbits     hostsim_DMA1CNT.bits
+#define DMA1STAL        hostsim_DMA1STAL
+#define DMA1STAH        hostsim_DMA1STAH
+#define DMA1PAD         hostsim_DMA1PAD
+
+#define INTCON2bits     hostsim_INTCON2.bits
+#define IEC0bits        hostsim_IEC0.bits
+#define IFS0bits        hostsim_IFS0.bits
+#define IEC1bits        hostsim_IEC1.bits
+#define IFS1bits        hostsim_IFS1.bits
+#define IEC2bits        hostsim_IEC2.bits
+#define IFS2bits        hostsim_IFS2.bits
+#define IPC0bits        hostsim_IPC0.bits
+#define IPC2bits        hostsim_IPC2.bits
+#define IPC6bits        hostsim_IPC6.bits
+#define IPC8bits        hostsim_IPC8.bits
+
+#define CLKDIVbits      hostsim_CLKDIV.bits
+#define PLLFBDbits      hostsim_PLLFBD.bits
+#define OSCCONbits      hostsim_OSCCON.bits
+#define RCON            hostsim_RCON.reg
+#define RCONbits        hostsim_RCON.bits
+
+#define PTCONbits       hostsim_PTCON.bits
+#define PTCON2bits      hostsim_PTCON2.bits
+#define CHOPbits        hostsim_CHOP.bits
+#define PWMCON3bits     hostsim_PWMCON3.bits
+#define AUXCON3bits     hostsim_AUXCON3.bits
+#define IOCON3          hostsim_IOCON3
+#define FCLCON3         hostsim_FCLCON3
+#define PHASE3          hostsim_PHASE3
+#define PDC3            hostsim_PDC3
+
+#define T1CONbits       hostsim_T1CON.bits
+#define T2CONbits       hostsim_T2CON.bits
+#define T3CONbits       hostsim_T3CON.bits
+#define T4CONbits       hostsim_T4CON.bits
+#define TMR1            ( *HostsimTmr1Get() )
+#define TMR2            ( *HostsimTmr2Get() )
+#define TMR3            hostsim_TMR3
+#define TMR3HLD         hostsim_TMR3HLD
+#define TMR4            ( *HostsimTmr4Get() )
+#define PR1             hostsim_PR1
+#define PR2             hostsim_PR2
+#define PR3             hostsim_PR3
+#define PR4             hostsim_PR4
+
+// *****************************************************************************
+// ************************** Compiler Extensions ******************************
+// *****************************************************************************
+
+// Note: Data placed in Program Memory or DMA memory by an attribute is made
+// volatile, so that the simulation model's writes (NVM programming, DMA
+// reception) are not hidden by constant folding.
+#define __align( n )            __attribute__(( aligned( n ) )) volatile
+#define __at( addr )
+#define space( s )              unused
+#define __interrupt( ... )
+#define no_auto_psv
+
+#define ClrWdt()                HostsimWdtClear()
+#define __builtin_disi( cnt )   ( (void) ( cnt ) )
+#define __builtin_nop()         ( (void) 0 )
+#define __builtin_mulss( a, b ) HostsimMulss( (a), (b) )
+#define __builtin_mulsu( a, b ) HostsimMulsu( (a), (b) )
+#define __builtin_muluu( a, b ) HostsimMuluu( (a), (b) )
+
+// The table page and offset of a Program Memory address are the upper and
+// lower 16 bits of the host address (see the DMA address registers).
+#define __builtin_tblpage( p )      ( (uint16_t) ( (uintptr_t) ( p ) >> 16 ) )
+#define __builtin_tbloffset( p )    ( (uint16_t) (uintptr_t) ( p ) )
+
+// The software reset instruction calls the simulation model, which does not
+// return (see HostsimReset).
+__asm__( ".macro reset\n"
+         "\tandq $-16, %rsp\n"
+         "\tcall HostsimReset\n"
+         ".endm" );
+
+#endif // HOSTSIM_XC_H_
\ No newline at end of file
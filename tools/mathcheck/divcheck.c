@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host check of the division-free scaling of the calibration path.
+///
+/// The divisions replaced by multiplication by a reciprocal are compared
+/// with the divisions over their full input domain:
+///
+///     UtilDiv100      - every int32 dividend, against the C division
+///                       operator (rounded towards zero).
+///     servo input     - every int16 position command, against the former
+///                       scaling ( pos << 21 ) / 1000 << 9 (32-bit, with the
+///                       l-shift wrapping as on the target - i.e. positions
+///                       outside of +/-1.024rad wrap identically).
+///
+/// The servo input scaling is observed through the position correction of
+/// the servo module, with the coefficient set { 0, 2^30, 0, ... } (i.e. the
+/// Q30 polynomial f(x) = x, which returns the scaled input exactly).
+///
+/// The check is built for each multiplication kernel of the reciprocal
+/// multiplications (see UTIL_MUL16_ENABLE and Makefile).
+///
+/// Build and execute with 'make check' (see Makefile).
+///
+/// The exit status is 1 if a result differs.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "mathstub.h"
+#include "servo.c"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define DIV_REPORT_MAX          5U          ///< Number of differing results listed per case.
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Number of differing results.
+static unsigned div_fail_cnt;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+static void    DivFail ( const char* name, long input, long result, long expect, unsigned* report_cnt );
+static void    DivUtilDiv100Check ( void );
+static int32_t DivServoInRef ( int16_t cmd_pos );
+static void    DivServoInCheck ( void );
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+int main ( void )
+{
+    printf( "Division-free scaling vs division (UTIL_MUL16_ENABLE = %d):\n", UTIL_MUL16_ENABLE );
+
+    DivUtilDiv100Check();
+    DivServoInCheck();
+
+    printf( "divcheck: %u failure(s)\n", div_fail_cnt );
+
+    return ( div_fail_cnt == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Record a differing result, listing the first of each case.
+////////////////////////////////////////////////////////////////////////////////
+static void DivFail ( const char* name, long input, long result, long expect, unsigned* report_cnt )
+{
+    if( *report_cnt < DIV_REPORT_MAX )
+    {
+        printf( "  FAIL %s input %ld: %ld, expected %ld\n", name, input, result, expect );
+        ( *report_cnt )++;
+    }
+
+    div_fail_cnt++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Check UtilDiv100 for every int32 dividend.
+////////////////////////////////////////////////////////////////////////////////
+static void DivUtilDiv100Check ( void )
+{
+    uint32_t dividend_u32 = 0;
+    int32_t  dividend;
+    unsigned report_cnt = 0;
+
+    do
+    {
+        dividend = (int32_t) dividend_u32;
+
+        if( UtilDiv100( dividend ) != ( dividend / 100 ) )
+        {
+            DivFail( "UtilDiv100", dividend, UtilDiv100( dividend ), dividend / 100, &report_cnt );
+        }
+
+        dividend_u32++;
+
+    } while( dividend_u32 != 0 );
+
+    printf( "  UtilDiv100     4294967296 dividends\n" );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the servo input of the former scaling.
+///
+/// @note   The l-shifts are performed as unsigned (i.e. wrapping, as the
+///         signed l-shift of the target), so that the result is defined for
+///         positions outside of +/-1.024rad.  The division is signed, as 
+///         performed by XC16 (the 16-bit unsigned divisor is converted to 
+///         the 32-bit signed type).
+////////////////////////////////////////////////////////////////////////////////
+static int32_t DivServoInRef ( int16_t cmd_pos )
+{
+    int32_t pos_in;
+
+    pos_in = (int32_t) ( (uint32_t) (int32_t) cmd_pos << SERVO_PWM_IN_SHIFT1 );
+    pos_in = pos_in / (int32_t) SERVO_PWM_IN_DIV;
+    pos_in = (int32_t) ( (uint32_t) pos_in << SERVO_PWM_IN_SHIFT2 );
+
+    return pos_in;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Check the servo input scaling for every int16 position command.
+////////////////////////////////////////////////////////////////////////////////
+static void DivServoInCheck ( void )
+{
+    int32_t  cmd_pos;
+    int32_t  pos_in;
+    unsigned report_cnt = 0;
+
+    memset( mathstub_coeff, 0, sizeof( mathstub_coeff ) );
+    mathstub_coeff[ 1 ] = 1L << SERVO_QNUM_CALC;
+    mathstub_cfg_gen++;
+
+    for( cmd_pos = INT16_MIN;
+         cmd_pos <= INT16_MAX;
+         cmd_pos++ )
+    {
+        pos_in = ServoPosCorrect( (int16_t) cmd_pos );
+
+        if( pos_in != DivServoInRef( (int16_t) cmd_pos ) )
+        {
+            DivFail( "servo input", cmd_pos, pos_in, DivServoInRef( (int16_t) cmd_pos ), &report_cnt );
+        }
+    }
+
+    printf( "  servo input         65536 position commands\n" );
+}
\ No newline at end of file
@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host check of the specialized polynomial evaluators.
+///
+/// The specialized evaluators of the calibration channels (see
+/// UTIL_POLY32_DEFINE) are compared with UtilPoly32, of the same Q-number
+/// and number of coefficients, over the full input domain of each channel:
+///
+///     ServoPoly       - the Q30 input of every int16 position command (i.e.
+///                       every position within +/-1.024rad, to which
+///                       commands outside of the range are wrapped).
+///     Vsense1Poly     - the Q30 input of every 12-bit ADC count.
+///     Vsense2Poly     - the Q30 input of every 12-bit ADC count.
+///
+/// for the default coefficient sets, the largest coefficient sets of each
+/// sign pattern, and pseudo-random sets, with all coefficients of magnitude
+/// less than 2^28 (so that no intermediate exceeds int32 over the domains).
+/// The results are required to be identical.
+///
+/// Build and execute with 'make check' (see Makefile).
+///
+/// The exit status is 1 if a result differs.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "mathstub.h"
+#include "servo.c"
+#include "vsense.c"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define EVAL_COEFF_LIM          ( 1L << 28 )    ///< Exclusive limit of the coefficient magnitudes.
+#define EVAL_RAND_SET_NUM       1000U       ///< Number of pseudo-random coefficient sets.
+
+/// Specialized evaluator of a calibration channel.
+typedef struct
+{
+    const char* name;                                           ///< Name of the evaluator.
+    int32_t     (*spec_eval)( int32_t var_in, const int32_t coeff[] );  ///< Specialized evaluator.
+    uint8_t     calc_qnum;                                      ///< Q-number of the channel.
+    uint8_t     coeff_len;                                      ///< Number of coefficients of the channel.
+    int32_t     var_len;                                        ///< Number of inputs.
+    int32_t     (*var_get)( int32_t var_idx );                  ///< Q-number input of an input index.
+
+} EVAL_CASE_S;
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Number of differing results.
+static unsigned eval_fail_cnt;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+static int32_t EvalServoVarGet ( int32_t var_idx );
+static int32_t EvalVsense1VarGet ( int32_t var_idx );
+static int32_t EvalVsense2VarGet ( int32_t var_idx );
+static void    EvalSetCheck ( const EVAL_CASE_S* eval_case, uint32_t* cmp_cnt );
+static void    EvalCaseCheck ( const EVAL_CASE_S* eval_case );
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+int main ( void )
+{
+    static const EVAL_CASE_S eval_case[] =
+    {
+        { "ServoPoly",   ServoPoly,   SERVO_QNUM_CALC,   CFG_PWM_COEFF_LEN,     2048, EvalServoVarGet   },
+        { "Vsense1Poly", Vsense1Poly, VSENSE1_QNUM_CALC, CFG_VSENSE1_COEFF_LEN, 4096, EvalVsense1VarGet },
+        { "Vsense2Poly", Vsense2Poly, VSENSE2_QNUM_CALC, CFG_VSENSE2_COEFF_LEN, 4096, EvalVsense2VarGet },
+    };
+
+    uint8_t case_idx;
+
+    printf( "Specialized evaluators vs UtilPoly32 (identical results):\n" );
+
+    for( case_idx = 0;
+         case_idx < sizeof( eval_case ) / sizeof( eval_case[ 0 ] );
+         case_idx++ )
+    {
+        EvalCaseCheck( &eval_case[ case_idx ] );
+    }
+
+    printf( "evalcheck: %u failure(s)\n", eval_fail_cnt );
+
+    return ( eval_fail_cnt == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the Q30 servo input of a position command (LSB = 0.001rad)
+///         offset from -1.024rad.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t EvalServoVarGet ( int32_t var_idx )
+{
+    return ( ( ( var_idx - 1024 ) * ( 1L << SERVO_PWM_IN_SHIFT1 ) ) / SERVO_PWM_IN_DIV ) *
+           ( 1L << SERVO_PWM_IN_SHIFT2 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the VSENSE1/2 input of an ADC count.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t EvalVsense1VarGet ( int32_t var_idx )
+{
+    return var_idx << ( VSENSE1_QNUM_CALC - VSENSE1_QNUM_RAW );
+}
+
+static int32_t EvalVsense2VarGet ( int32_t var_idx )
+{
+    return var_idx << ( VSENSE2_QNUM_CALC - VSENSE2_QNUM_RAW );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Compare the evaluators for the present coefficient set over the
+///         input domain.
+////////////////////////////////////////////////////////////////////////////////
+static void EvalSetCheck ( const EVAL_CASE_S* eval_case, uint32_t* cmp_cnt )
+{
+    int32_t var_idx;
+    int32_t var_in;
+    int32_t spec_out;
+    int32_t poly_out;
+
+    for( var_idx = 0;
+         var_idx < eval_case->var_len;
+         var_idx++ )
+    {
+        var_in   = eval_case->var_get( var_idx );
+        spec_out = eval_case->spec_eval( var_in, mathstub_coeff );
+        poly_out = UtilPoly32( var_in, eval_case->calc_qnum, mathstub_coeff, eval_case->coeff_len );
+
+        if( spec_out != poly_out )
+        {
+            printf( "  FAIL %s input %ld: specialized %ld, UtilPoly32 %ld\n",
+                    eval_case->name, (long) var_in, (long) spec_out, (long) poly_out );
+            eval_fail_cnt++;
+        }
+
+        ( *cmp_cnt )++;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Compare the evaluators for all coefficient sets.
+////////////////////////////////////////////////////////////////////////////////
+static void EvalCaseCheck ( const EVAL_CASE_S* eval_case )
+{
+    // Default coefficient sets of the configuration (see cfg.c).
+    static const int32_t eval_default[][ MATHSTUB_COEFF_LEN ] =
+    {
+        { 0, 100000, 0, 0, 0, 0 },
+        { 0,  10000, 0, 0, 0, 0 },
+    };
+
+    uint32_t cmp_cnt = 0;
+    uint32_t set_cnt = 0;
+    uint32_t set_idx;
+    uint8_t  coeff_idx;
+
+    for( set_idx = 0;
+         set_idx < sizeof( eval_default ) / sizeof( eval_default[ 0 ] );
+         set_idx++ )
+    {
+        memcpy( mathstub_coeff, eval_default[ set_idx ], sizeof( mathstub_coeff ) );
+        EvalSetCheck( eval_case, &cmp_cnt );
+        set_cnt++;
+    }
+
+    // Largest coefficients of each sign pattern.
+    for( set_idx = 0;
+         set_idx < ( 1U << MATHSTUB_COEFF_LEN );
+         set_idx++ )
+    {
+        for( coeff_idx = 0;
+             coeff_idx < MATHSTUB_COEFF_LEN;
+             coeff_idx++ )
+        {
+            mathstub_coeff[ coeff_idx ] = ( ( set_idx >> coeff_idx ) & 1U ) ?
+                                              -( EVAL_COEFF_LIM - 1 ) : ( EVAL_COEFF_LIM - 1 );
+        }
+
+        EvalSetCheck( eval_case, &cmp_cnt );
+        set_cnt++;
+    }
+
+    // Pseudo-random coefficient sets.
+    for( set_idx = 0;
+         set_idx < EVAL_RAND_SET_NUM;
+         set_idx++ )
+    {
+        for( coeff_idx = 0;
+             coeff_idx < MATHSTUB_COEFF_LEN;
+             coeff_idx++ )
+        {
+            mathstub_coeff[ coeff_idx ] = (int32_t) ( MathStubRand() % ( 2UL * EVAL_COEFF_LIM - 1U ) ) -
+                                          ( EVAL_COEFF_LIM - 1 );
+        }
+
+        EvalSetCheck( eval_case, &cmp_cnt );
+        set_cnt++;
+    }
+
+    printf( "  %-12s %4u sets x %4u inputs: %u results compared\n",
+            eval_case->name,
+            (unsigned) set_cnt,
+            (unsigned) eval_case->var_len,
+            (unsigned) cmp_cnt );
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host check of the servo calibration lookup table interpolation.
+///
+/// The servo module is compiled with the lookup table enabled (see
+/// SERVO_LUT_ENABLE) for a table size (SERVO_LUT_SIZE_LOG2, set at build
+/// time - see Makefile), the table is built by ServoLutService for each
+/// coefficient set, and the correction of every position command within
+/// +/-1.024rad by interpolation of the table is compared with an exact
+/// evaluation of the polynomial at the command's position.
+///
+/// The coefficient sets are a nominal servo calibration (1500us at 0rad,
+/// 500us/rad, with small higher-order terms) and pseudo-random sets with all
+/// coefficients of magnitude less than 2^28.  The error of each position is
+/// checked against the bound (LSB = 0.01us):
+///
+///     h^2 / 8 * max|f''|      - linear interpolation (see SERVO_LUT_SIZE_LOG2)
+///   + ( n - 1 ) * 1.024^( n - 2 ) - Horner evaluation of the entries (see UtilPoly32)
+///   + max|f'| * 2^-30         - Q30 representation of the entry positions
+///   + 1                       - truncation of the interpolated term
+///
+/// where h is the segment width (rad), and f' and f'' are the derivatives of
+/// the polynomial over +/-1.024rad.
+///
+/// For the nominal calibration, the interpolation error and the difference of
+/// the applied PWM (LSB = 1us) from that of evaluation of the polynomial on
+/// each command (SERVO_LUT_ENABLE = 0) are reported.
+///
+/// Build and execute with 'make check' (see Makefile).
+///
+/// The exit status is 1 if the bound is exceeded.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "mathstub.h"
+#include "servo.c"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#if ( SERVO_LUT_ENABLE == 0 )
+#error "The check is built with the servo lookup table enabled (see Makefile)."
+#endif
+
+#define LUT_COEFF_LIM           ( 1L << 28 )    ///< Exclusive limit of the random coefficient magnitudes.
+#define LUT_RAND_SET_NUM        100U        ///< Number of pseudo-random coefficient sets.
+#define LUT_DERIV_STEP_LEN      32768U      ///< Number of derivative samples over +/-1.024rad.
+
+/// Result of a coefficient set.
+typedef struct
+{
+    double   err_max;       ///< Maximum interpolation error (LSB = 0.01us).
+    double   bound;         ///< Error bound (LSB = 0.01us).
+    uint16_t pwm_diff_max;  ///< Maximum applied PWM difference from the polynomial evaluation (LSB = 1us).
+
+} LUT_RESULT_S;
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Number of exceeded bounds.
+static unsigned lut_fail_cnt;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+static long double LutExact ( long double pos, uint8_t deriv );
+static void        LutSetCheck ( LUT_RESULT_S* result );
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+int main ( void )
+{
+    // Nominal servo calibration (LSB = 0.01us/rad^x).
+    static const int32_t lut_nominal[ MATHSTUB_COEFF_LEN ] =
+    {
+        150000, 50000, -2000, 6000, -1000, 800
+    };
+
+    LUT_RESULT_S nominal;
+    LUT_RESULT_S rand_result;
+    double       ratio_max = 0.0;
+    uint32_t     set_idx;
+    uint8_t      coeff_idx;
+
+    memcpy( mathstub_coeff, lut_nominal, sizeof( mathstub_coeff ) );
+    LutSetCheck( &nominal );
+
+    for( set_idx = 0;
+         set_idx < LUT_RAND_SET_NUM;
+         set_idx++ )
+    {
+        for( coeff_idx = 0;
+             coeff_idx < MATHSTUB_COEFF_LEN;
+             coeff_idx++ )
+        {
+            mathstub_coeff[ coeff_idx ] = (int32_t) ( MathStubRand() % ( 2UL * LUT_COEFF_LIM - 1U ) ) -
+                                          ( LUT_COEFF_LIM - 1 );
+        }
+
+        LutSetCheck( &rand_result );
+
+        ratio_max = fmax( ratio_max, rand_result.err_max / rand_result.bound );
+    }
+
+    printf( "lutcheck SERVO_LUT_SIZE_LOG2 = %2d (%4u entries, %4u bytes): "
+            "nominal error %7.2fus (bound %7.2fus, applied PWM vs polynomial %2uus), "
+            "%u random sets error/bound max %.2f, %u failure(s)\n",
+            SERVO_LUT_SIZE_LOG2,
+            (unsigned) SERVO_LUT_LEN,
+            (unsigned) sizeof( servo_lut ),
+            nominal.err_max / 100.0,
+            nominal.bound   / 100.0,
+            (unsigned) nominal.pwm_diff_max,
+            (unsigned) LUT_RAND_SET_NUM,
+            ratio_max,
+            lut_fail_cnt );
+
+    return ( lut_fail_cnt == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Exact evaluation of the coefficient set, or of its derivative.
+///
+/// @param  pos
+///             The position (rad).
+/// @param  deriv
+///             The order of the derivative (0 - the polynomial).
+///
+/// @return The value (LSB = 0.01us / rad^deriv).
+////////////////////////////////////////////////////////////////////////////////
+static long double LutExact ( long double pos, uint8_t deriv )
+{
+    long double result = 0.0L;
+    long double factor;
+    uint8_t     coeff_idx;
+    uint8_t     deriv_idx;
+
+    for( coeff_idx = MATHSTUB_COEFF_LEN;
+         coeff_idx > deriv;
+         coeff_idx-- )
+    {
+        factor = 1.0L;
+
+        for( deriv_idx = 0;
+             deriv_idx < deriv;
+             deriv_idx++ )
+        {
+            factor *= ( coeff_idx - 1U ) - deriv_idx;
+        }
+
+        result = ( result * pos ) + ( factor * mathstub_coeff[ coeff_idx - 1 ] );
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Build the table for the present coefficient set and check the
+///         interpolation of every position within +/-1.024rad.
+////////////////////////////////////////////////////////////////////////////////
+static void LutSetCheck ( LUT_RESULT_S* result )
+{
+    double      deriv1_max = 0.0;
+    double      deriv2_max = 0.0;
+    long double pos;
+    double      seg_width;
+    double      err;
+    uint32_t    step_idx;
+    int32_t     cmd_pos;
+    int32_t     var_in;
+    int32_t     lut_out;
+    int32_t     poly_out;
+    uint16_t    pwm_diff;
+
+    memset( result, 0, sizeof( *result ) );
+
+    // Build the table from the coefficient set.
+    mathstub_cfg_gen++;
+
+    do
+    {
+        ServoLutService();
+    } while( servo_lut_valid == false );
+
+    // Determine the derivative magnitudes, and the bound.
+    for( step_idx = 0;
+         step_idx <= LUT_DERIV_STEP_LEN;
+         step_idx++ )
+    {
+        pos = -1.024L + ( 2.048L * step_idx ) / LUT_DERIV_STEP_LEN;
+
+        deriv1_max = fmax( deriv1_max, fabs( (double) LutExact( pos, 1U ) ) );
+        deriv2_max = fmax( deriv2_max, fabs( (double) LutExact( pos, 2U ) ) );
+    }
+
+    seg_width     = 2.048 / ( 1U << SERVO_LUT_SIZE_LOG2 );
+    result->bound = ( seg_width * seg_width / 8.0 ) * deriv2_max +
+                    ( MATHSTUB_COEFF_LEN - 1U ) * pow( 1.024, MATHSTUB_COEFF_LEN - 2U ) +
+                    ldexp( deriv1_max, -30 ) +
+                    1.0;
+
+    for( cmd_pos = SERVO_LUT_POS_MIN;
+         cmd_pos <= SERVO_LUT_POS_MAX;
+         cmd_pos++ )
+    {
+        lut_out = ServoPosCorrect( (int16_t) cmd_pos );
+        err     = fabs( (double) ( lut_out - LutExact( cmd_pos / 1000.0L, 0U ) ) );
+
+        if( err > result->bound )
+        {
+            printf( "  FAIL position %ld: table %ld, exact %.2f, bound %.2f\n",
+                    (long) cmd_pos, (long) lut_out,
+                    (double) LutExact( cmd_pos / 1000.0L, 0U ), result->bound );
+            lut_fail_cnt++;
+        }
+
+        result->err_max = fmax( result->err_max, err );
+
+        // Applied PWM of evaluation of the polynomial on each command (i.e.
+        // the module's input scaling and polynomial evaluator).
+        var_in   = ( ( cmd_pos * ( 1L << 21 ) ) / 1000 ) * ( 1L << 9 );
+        poly_out = ServoPoly( var_in, mathstub_coeff );
+        pwm_diff = (uint16_t) abs( UtilDiv100( lut_out ) - UtilDiv100( poly_out ) );
+
+        if( pwm_diff > result->pwm_diff_max )
+        {
+            result->pwm_diff_max = pwm_diff;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host stubs of the firmware interfaces used by the math checks.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "mathstub.h"
+#include "adc.h"
+#include "can.h"
+#include "ina219.h"
+#include "pwm.h"
+#include "tmr.h"
+#include "wdt.h"
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+int32_t mathstub_coeff[ MATHSTUB_COEFF_LEN ];
+
+uint16_t mathstub_cfg_gen = 1;
+
+/// State of the pseudo-random sequence.
+static uint32_t mathstub_rand_state = 0x2545F491UL;
+
+/// Payload of transmitted messages (discarded).
+static uint16_t mathstub_tx_discard[ 4 ];
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+uint32_t MathStubRand ( void )
+{
+    mathstub_rand_state ^= mathstub_rand_state << 13;
+    mathstub_rand_state ^= mathstub_rand_state >> 17;
+    mathstub_rand_state ^= mathstub_rand_state << 5;
+
+    return mathstub_rand_state;
+}
+
+// ---- Firmware interfaces ----------------------------------------------------
+
+bool CANRxGet ( CAN_RX_MSG_TYPE_E rx_msg_type, uint16_t payload[ 4 ] )
+{
+    (void) rx_msg_type;
+    (void) payload;
+    return false;
+}
+
+uint32_t CANRxTickGet ( CAN_RX_MSG_TYPE_E rx_msg_type )
+{
+    (void) rx_msg_type;
+    return 0;
+}
+
+uint16_t* CANTxAcquire ( CAN_TX_MSG_TYPE_E tx_msg_type )
+{
+    (void) tx_msg_type;
+    return mathstub_tx_discard;
+}
+
+void CANTxCommit ( CAN_TX_MSG_TYPE_E tx_msg_type )
+{
+    (void) tx_msg_type;
+}
+
+uint16_t CfgGenGet ( void )                     { return mathstub_cfg_gen; }
+CFG_CAL_E CfgPWMCalTypeGet ( void )             { return CFG_CAL_POLY; }
+const UTIL_PWL_S* CfgPWMPwlGet ( void )         { return NULL; }
+const int32_t* CfgPWMCoeffGet ( void )          { return mathstub_coeff; }
+const int32_t* CfgVsense1CoeffGet ( void )      { return mathstub_coeff; }
+const int32_t* CfgVsense2CoeffGet ( void )      { return mathstub_coeff; }
+uint16_t ADCGet ( ADC_AIN_E adc_sel )           { (void) adc_sel; return 0; }
+uint16_t INA219VoltGet ( void )                 { return 0; }
+uint16_t INA219AmpGet ( void )                  { return 0; }
+void PWMDutySet ( uint16_t pwm_duty )           { (void) pwm_duty; }
+uint32_t TMRTickGet ( void )                    { return 0; }
+uint16_t TMRCycleGet ( void )                   { return 0; }
+void WDTService ( void )                        { }
\ No newline at end of file
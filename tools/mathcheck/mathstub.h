@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host stubs of the firmware interfaces used by the math checks.
+///
+/// The firmware modules under check are compiled into each check (by 
+/// inclusion of their source file), and the interfaces of the modules they
+/// use are stubbed here.  All calibration channels return the same 
+/// coefficient set, which is set by the check; the polynomial calibration
+/// type is configured, no CAN messages are received, and transmitted 
+/// messages are discarded.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MATHSTUB_H_
+#define MATHSTUB_H_
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "cfg.h"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define MATHSTUB_COEFF_LEN      6U      ///< Number of coefficients of a set.
+
+#if ( CFG_PWM_COEFF_LEN     != MATHSTUB_COEFF_LEN ) || \
+    ( CFG_VSENSE1_COEFF_LEN != MATHSTUB_COEFF_LEN ) || \
+    ( CFG_VSENSE2_COEFF_LEN != MATHSTUB_COEFF_LEN )
+#error "The math checks are defined for 6 coefficients per channel."
+#endif
+
+// *****************************************************************************
+// ************************** Declarations *************************************
+// *****************************************************************************
+
+/// Coefficient set returned for all calibration channels.
+extern int32_t mathstub_coeff[ MATHSTUB_COEFF_LEN ];
+
+/// Configuration data generation (see CfgGenGet) - incremented by the check
+/// on change of the coefficient set.
+extern uint16_t mathstub_cfg_gen;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return a pseudo-random 32-bit value (xorshift32).
+///
+/// @note   The sequence is fixed (i.e. identical for each execution of a
+///         check), so that check results are reproducible.
+////////////////////////////////////////////////////////////////////////////////
+uint32_t MathStubRand ( void );
+
+#endif // MATHSTUB_H_
\ No newline at end of file
@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host check of the Horner evaluation of the calibration polynomials.
+///
+/// UtilPoly32 (Horner form) and the former power-series evaluation (the
+/// bench module's reference evaluator, BenchPoly32Pow) are compared with an
+/// exact evaluation of the polynomial over the input domain of each
+/// calibration channel:
+///
+///     servo   - every position command within +/-1.024rad (Q30 input,
+///               |x| <= 1.024).
+///     vsense  - every 12-bit ADC count (Q30 input, 0 <= x < 1).
+///
+/// for the default coefficient sets, the largest coefficient sets of each
+/// sign pattern, and pseudo-random sets, with all coefficients of magnitude
+/// less than 2^28 (so that no intermediate exceeds int32 over the domains).
+///
+/// The following bounds (LSB = 1 coefficient LSB, n = 6 coefficients,
+/// X = max( 1, |x| ), q = 30) are checked for each input:
+///
+///     Horner - exact          <= ( n - 1 ) * X^( n - 2 )      (see UtilPoly32)
+///     power series - exact    <  sum[k = 1..n-1]( 1 + ( k - 1 ) * X^( k - 2 ) * 2^28 / 2^q )
+///     Horner - power series   <= sum of the above
+///
+/// i.e. the Horner - power series difference is at most 13.1 LSB over the
+/// servo domain and 12.5 LSB over the VSENSE domain.  Each power term of the
+/// power series is truncated by less than 1 LSB of Q30 per multiplication
+/// (k - 1 multiplications for term k, each scaling the previous truncation
+/// by x), which is scaled by the coefficient on multiplication, plus less
+/// than 1 LSB of truncation of the coefficient product.
+///
+/// Build and execute with 'make check' (see Makefile).
+///
+/// The exit status is 1 if a bound is exceeded.
+////////////////////////////////////////////////////////////////////////////////
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// *****************************************************************************
+// ************************** User Include Files *******************************
+// *****************************************************************************
+
+#include "mathstub.h"
+#include "bench.c"
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define POLY_QNUM               30U         ///< Polynomial calculation Q-number of all channels.
+#define POLY_COEFF_LIM          ( 1L << 28 )    ///< Exclusive limit of the coefficient magnitudes.
+#define POLY_RAND_SET_NUM       1000U       ///< Number of pseudo-random coefficient sets per domain.
+
+/// Input domain of a calibration channel.
+typedef struct
+{
+    const char* name;                   ///< Name of the domain.
+    int32_t     var_len;                ///< Number of inputs.
+    int32_t     (*var_get)( int32_t );  ///< Q30 input of an input index.
+    double      var_max;                ///< Maximum input magnitude (unscaled).
+
+} POLY_DOMAIN_S;
+
+/// Error statistics of a domain.
+typedef struct
+{
+    double   horner_max;    ///< Maximum Horner - exact difference.
+    double   pow_max;       ///< Maximum power series - exact difference.
+    int64_t  diff_max;      ///< Maximum Horner - power series difference.
+    uint32_t set_cnt;       ///< Number of coefficient sets.
+
+} POLY_STAT_S;
+
+// *****************************************************************************
+// ************************** Definitions **************************************
+// *****************************************************************************
+
+/// Number of exceeded bounds.
+static unsigned poly_fail_cnt;
+
+// *****************************************************************************
+// ************************** Function Prototypes ******************************
+// *****************************************************************************
+
+static int32_t     PolyServoVarGet ( int32_t var_idx );
+static int32_t     PolyVsenseVarGet ( int32_t var_idx );
+static long double PolyExact ( int32_t var_in );
+static double      PolyHornerBound ( double var_max );
+static double      PolyPowBound ( double var_max );
+static void        PolySetCheck ( const POLY_DOMAIN_S* domain, POLY_STAT_S* stat );
+static void        PolyDomainCheck ( const POLY_DOMAIN_S* domain );
+
+// *****************************************************************************
+// ************************** Global Functions *********************************
+// *****************************************************************************
+
+int main ( void )
+{
+    static const POLY_DOMAIN_S poly_domain[] =
+    {
+        { "servo  (+/-1.024rad)", 2048, PolyServoVarGet,  1.024 },
+        { "vsense (12-bit ADC) ", 4096, PolyVsenseVarGet, 1.0   },
+    };
+
+    uint8_t domain_idx;
+
+    printf( "Horner (UtilPoly32) vs power series (BenchPoly32Pow), |c| < 2^28 (LSB = 1 coefficient LSB):\n" );
+
+    for( domain_idx = 0;
+         domain_idx < sizeof( poly_domain ) / sizeof( poly_domain[ 0 ] );
+         domain_idx++ )
+    {
+        PolyDomainCheck( &poly_domain[ domain_idx ] );
+    }
+
+    printf( "polycheck: %u failure(s)\n", poly_fail_cnt );
+
+    return ( poly_fail_cnt == 0 ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// *****************************************************************************
+// ************************** Static Functions *********************************
+// *****************************************************************************
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the Q30 servo input of a position command (LSB = 0.001rad)
+///         offset from -1.024rad, as scaled by the servo module.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t PolyServoVarGet ( int32_t var_idx )
+{
+    return ( ( ( var_idx - 1024 ) * ( 1L << 21 ) ) / 1000 ) * ( 1L << 9 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the Q30 VSENSE input of an ADC count, as scaled by the
+///         VSENSE module.
+////////////////////////////////////////////////////////////////////////////////
+static int32_t PolyVsenseVarGet ( int32_t var_idx )
+{
+    return var_idx << ( POLY_QNUM - 12U );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Exact evaluation of the coefficient set (coefficient units).
+///
+/// @note   The Q30 input is exactly represented, and the result is within
+///         2^-30 LSB of the exact value (64-bit mantissa).
+////////////////////////////////////////////////////////////////////////////////
+static long double PolyExact ( int32_t var_in )
+{
+    long double var    = ldexpl( (long double) var_in, -(int) POLY_QNUM );
+    long double result = 0.0L;
+    uint8_t     coeff_idx;
+
+    for( coeff_idx = MATHSTUB_COEFF_LEN;
+         coeff_idx > 0;
+         coeff_idx-- )
+    {
+        result = ( result * var ) + mathstub_coeff[ coeff_idx - 1 ];
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the Horner error bound of UtilPoly32 (see util.h).
+////////////////////////////////////////////////////////////////////////////////
+static double PolyHornerBound ( double var_max )
+{
+    return ( MATHSTUB_COEFF_LEN - 1U ) * pow( fmax( 1.0, var_max ), MATHSTUB_COEFF_LEN - 2U );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Return the error bound of the power series evaluation.
+////////////////////////////////////////////////////////////////////////////////
+static double PolyPowBound ( double var_max )
+{
+    double  bound = 0.0;
+    uint8_t pow_idx;
+
+    for( pow_idx = 1;
+         pow_idx < MATHSTUB_COEFF_LEN;
+         pow_idx++ )
+    {
+        bound += 1.0;
+
+        if( pow_idx >= 2U )
+        {
+            bound += ( pow_idx - 1U ) * pow( fmax( 1.0, var_max ), pow_idx - 2U ) *
+                     ( (double) POLY_COEFF_LIM / ( 1UL << POLY_QNUM ) );
+        }
+    }
+
+    return bound;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Check the present coefficient set over a domain.
+////////////////////////////////////////////////////////////////////////////////
+static void PolySetCheck ( const POLY_DOMAIN_S* domain, POLY_STAT_S* stat )
+{
+    double  horner_bound = PolyHornerBound( domain->var_max );
+    double  pow_bound    = PolyPowBound( domain->var_max );
+    int32_t var_idx;
+    int32_t var_in;
+    int32_t horner_out;
+    int32_t pow_out;
+    double  horner_err;
+    double  pow_err;
+    int64_t diff;
+
+    for( var_idx = 0;
+         var_idx < domain->var_len;
+         var_idx++ )
+    {
+        var_in     = domain->var_get( var_idx );
+        horner_out = UtilPoly32( var_in, POLY_QNUM, mathstub_coeff, MATHSTUB_COEFF_LEN );
+        pow_out    = BenchPoly32Pow( var_in, POLY_QNUM, mathstub_coeff, MATHSTUB_COEFF_LEN );
+
+        horner_err = fabs( (double) ( horner_out - PolyExact( var_in ) ) );
+        pow_err    = fabs( (double) ( pow_out    - PolyExact( var_in ) ) );
+        diff       = llabs( (int64_t) horner_out - pow_out );
+
+        if( ( horner_err > horner_bound ) ||
+            ( pow_err   >= pow_bound    ) ||
+            ( diff       > horner_bound + pow_bound ) )
+        {
+            printf( "  FAIL %s input %ld: Horner %ld, power series %ld, exact %.3f\n",
+                    domain->name, (long) var_in, (long) horner_out, (long) pow_out,
+                    (double) PolyExact( var_in ) );
+            poly_fail_cnt++;
+        }
+
+        stat->horner_max = fmax( stat->horner_max, horner_err );
+        stat->pow_max    = fmax( stat->pow_max,    pow_err    );
+
+        if( diff > stat->diff_max )
+        {
+            stat->diff_max = diff;
+        }
+    }
+
+    stat->set_cnt++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief  Check all coefficient sets over a domain, and report the maximum
+///         differences.
+////////////////////////////////////////////////////////////////////////////////
+static void PolyDomainCheck ( const POLY_DOMAIN_S* domain )
+{
+    // Default coefficient sets of the configuration (see cfg.c).
+    static const int32_t poly_default[][ MATHSTUB_COEFF_LEN ] =
+    {
+        { 0, 100000, 0, 0, 0, 0 },
+        { 0,  10000, 0, 0, 0, 0 },
+    };
+
+    POLY_STAT_S stat = { 0 };
+    uint32_t    set_idx;
+    uint8_t     coeff_idx;
+
+    for( set_idx = 0;
+         set_idx < sizeof( poly_default ) / sizeof( poly_default[ 0 ] );
+         set_idx++ )
+    {
+        memcpy( mathstub_coeff, poly_default[ set_idx ], sizeof( mathstub_coeff ) );
+        PolySetCheck( domain, &stat );
+    }
+
+    // Largest coefficients of each sign pattern.
+    for( set_idx = 0;
+         set_idx < ( 1U << MATHSTUB_COEFF_LEN );
+         set_idx++ )
+    {
+        for( coeff_idx = 0;
+             coeff_idx < MATHSTUB_COEFF_LEN;
+             coeff_idx++ )
+        {
+            mathstub_coeff[ coeff_idx ] = ( ( set_idx >> coeff_idx ) & 1U ) ?
+                                              -( POLY_COEFF_LIM - 1 ) : ( POLY_COEFF_LIM - 1 );
+        }
+
+        PolySetCheck( domain, &stat );
+    }
+
+    // Pseudo-random coefficient sets.
+    for( set_idx = 0;
+         set_idx < POLY_RAND_SET_NUM;
+         set_idx++ )
+    {
+        for( coeff_idx = 0;
+             coeff_idx < MATHSTUB_COEFF_LEN;
+             coeff_idx++ )
+        {
+            mathstub_coeff[ coeff_idx ] = (int32_t) ( MathStubRand() % ( 2UL * POLY_COEFF_LIM - 1U ) ) -
+                                          ( POLY_COEFF_LIM - 1 );
+        }
+
+        PolySetCheck( domain, &stat );
+    }
+
+    printf( "  %s %4u sets: Horner-exact %5.2f (bound %5.2f)  power-exact %5.2f (bound %5.2f)  Horner-power %2ld (bound %5.2f)\n",
+            domain->name,
+            (unsigned) stat.set_cnt,
+            stat.horner_max, PolyHornerBound( domain->var_max ),
+            stat.pow_max,    PolyPowBound( domain->var_max ),
+            (long) stat.diff_max,
+            PolyHornerBound( domain->var_max ) + PolyPowBound( domain->var_max ) );
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @file
+/// @brief Host build substitute of the XC16 device header.
+///
+/// The firmware modules compiled into the checks do not access device 
+/// registers; the 16x16-bit hardware multiplications of the multiplication
+/// kernel (see UTIL_MUL16_ENABLE) are substituted by C multiplication.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef MATHCHECK_XC_H_
+#define MATHCHECK_XC_H_
+
+// *****************************************************************************
+// ************************** System Include Files *****************************
+// *****************************************************************************
+
+#include <stdint.h>
+
+// *****************************************************************************
+// ************************** Defines ******************************************
+// *****************************************************************************
+
+#define __builtin_mulss( a, b ) ( (int32_t) (int16_t) (a) * (int16_t) (b) )
+#define __builtin_mulsu( a, b ) ( (int32_t) (int16_t) (a) * (int32_t) (uint16_t) (b) )
+#define __builtin_muluu( a, b ) ( (uint32_t) (uint16_t) (a) * (uint16_t) (b) )
+
+#endif // MATHCHECK_XC_H_
\ No newline at end of file